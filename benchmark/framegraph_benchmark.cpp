@@ -0,0 +1,740 @@
+// Frame graph setup/compile/execute benchmark on synthetic graphs, runs against a no-op device.
+// Build with benchmark/CMakeLists.txt:
+//	cmake -S benchmark -B build/benchmark && cmake --build build/benchmark && build/benchmark/framegraph_benchmark
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "framegraph/framegraph.h"
+#include "framegraph/framegraph_buffer.h"
+#include "framegraph/framegraph_template.h"
+#include "framegraph/framegraph_texture.h"
+#include "rhi/render_queue.h"
+#include "rhi/tracked_resources.h"
+
+#include "null_device.h"
+
+using namespace light::fg;
+
+// every heap allocation of the process is counted, the header keeps the size for the live byte count
+namespace
+{
+	std::atomic<uint64_t> g_num_allocations{ 0 };
+	std::atomic<int64_t> g_live_bytes{ 0 };
+	std::atomic<int64_t> g_peak_bytes{ 0 };
+
+	constexpr size_t kAllocationHeader = 16;
+
+	void* CountedAllocate(size_t size)
+	{
+		auto* memory = static_cast<unsigned char*>(std::malloc(size + kAllocationHeader));
+		if (!memory)
+		{
+			throw std::bad_alloc();
+		}
+
+		*reinterpret_cast<size_t*>(memory) = size;
+
+		++g_num_allocations;
+		auto live = g_live_bytes += static_cast<int64_t>(size);
+		auto peak = g_peak_bytes.load();
+		while (live > peak && !g_peak_bytes.compare_exchange_weak(peak, live))
+		{
+		}
+
+		return memory + kAllocationHeader;
+	}
+
+	void CountedFree(void* ptr)
+	{
+		if (ptr)
+		{
+			auto* memory = static_cast<unsigned char*>(ptr) - kAllocationHeader;
+			g_live_bytes -= static_cast<int64_t>(*reinterpret_cast<size_t*>(memory));
+			std::free(memory);
+		}
+	}
+}
+
+void* operator new(size_t size) { return CountedAllocate(size); }
+void* operator new[](size_t size) { return CountedAllocate(size); }
+void operator delete(void* ptr) noexcept { CountedFree(ptr); }
+void operator delete[](void* ptr) noexcept { CountedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { CountedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { CountedFree(ptr); }
+
+namespace
+{
+	struct PassData
+	{
+		FrameGraphHandle output;
+	};
+
+	using ExecuteFunc = void(*)(const PassData&, FrameGraphPassResources&, light::rhi::Device*, light::rhi::CommandList*);
+
+	void ExecuteNothing(const PassData&, FrameGraphPassResources&, light::rhi::Device*, light::rhi::CommandList*)
+	{
+	}
+
+	FrameGraphHandle CreateTexture(FrameGraph::Builder& builder, uint32_t size, FrameGraphAccess access = FrameGraphAccess::kRenderTarget)
+	{
+		light::rhi::TextureDesc desc;
+		desc.width = size;
+		desc.height = size;
+		desc.format = light::rhi::Format::RGBA8_UNORM;
+
+		auto handle = builder.Create<FrameGraphTexture>("texture", std::move(desc));
+		return builder.Write(handle, access);
+	}
+
+	// pass i reads the output of pass i - 1
+	uint32_t BuildChain(FrameGraph& framegraph, uint32_t num_passes)
+	{
+		FrameGraphHandle previous = 0;
+		for (uint32_t i = 0; i < num_passes; ++i)
+		{
+			previous = framegraph.AddPass<PassData>("chain",
+				[&](FrameGraph::Builder& builder, PassData& data)
+				{
+					if (i > 0)
+					{
+						builder.Read(previous, FrameGraphAccess::kShaderResource);
+					}
+
+					data.output = CreateTexture(builder, 256 << (i % 4));
+
+					if (i + 1 == num_passes)
+					{
+						builder.SetSideEffect();
+					}
+				}, ExecuteNothing).output;
+		}
+
+		return num_passes;
+	}
+
+	// one source fanned out to every pass, all of them gathered by the last one
+	uint32_t BuildFan(FrameGraph& framegraph, uint32_t num_passes)
+	{
+		auto source = framegraph.AddPass<PassData>("source",
+			[&](FrameGraph::Builder& builder, PassData& data)
+			{
+				data.output = CreateTexture(builder, 1024);
+			}, ExecuteNothing).output;
+
+		std::vector<FrameGraphHandle> outputs;
+		outputs.reserve(num_passes);
+		for (uint32_t i = 2; i < num_passes; ++i)
+		{
+			outputs.push_back(framegraph.AddPass<PassData>("fan",
+				[&](FrameGraph::Builder& builder, PassData& data)
+				{
+					builder.Read(source, FrameGraphAccess::kShaderResource);
+					data.output = CreateTexture(builder, 256);
+				}, ExecuteNothing).output);
+		}
+
+		framegraph.AddPass<PassData>("gather",
+			[&](FrameGraph::Builder& builder, PassData&)
+			{
+				for (auto output : outputs)
+				{
+					builder.Read(output, FrameGraphAccess::kShaderResource);
+				}
+				builder.SetSideEffect();
+			}, ExecuteNothing);
+
+		return num_passes;
+	}
+
+	// every pass writes kRandomResourcesPerPass uavs, more than fit in one render target, and reads a few outputs of earlier passes
+	constexpr uint32_t kRandomResourcesPerPass = 10;
+
+	uint32_t BuildRandom(FrameGraph& framegraph, uint32_t num_passes)
+	{
+		std::mt19937 random(7);
+		std::vector<FrameGraphHandle> outputs;
+		outputs.reserve(num_passes * kRandomResourcesPerPass);
+
+		for (uint32_t i = 0; i < num_passes; ++i)
+		{
+			framegraph.AddPass<PassData>("random",
+				[&](FrameGraph::Builder& builder, PassData&)
+				{
+					for (uint32_t j = 0; j < 4 && !outputs.empty(); ++j)
+					{
+						builder.Read(outputs[random() % outputs.size()], FrameGraphAccess::kShaderResource);
+					}
+
+					for (uint32_t j = 0; j < kRandomResourcesPerPass; ++j)
+					{
+						outputs.push_back(CreateTexture(builder, 64 << (random() % 4), FrameGraphAccess::kUnorderedAccess));
+					}
+
+					if (i + 1 == num_passes)
+					{
+						builder.SetSideEffect();
+					}
+				}, ExecuteNothing);
+		}
+
+		return num_passes * kRandomResourcesPerPass;
+	}
+
+	// only every 10th pass reaches the output, the rest is culled
+	uint32_t BuildCulled(FrameGraph& framegraph, uint32_t num_passes)
+	{
+		std::vector<FrameGraphHandle> kept;
+		for (uint32_t i = 0; i < num_passes; ++i)
+		{
+			auto output = framegraph.AddPass<PassData>("culled",
+				[&](FrameGraph::Builder& builder, PassData& data)
+				{
+					data.output = CreateTexture(builder, 512);
+				}, ExecuteNothing).output;
+
+			if (i % 10 == 0)
+			{
+				kept.push_back(output);
+			}
+		}
+
+		framegraph.AddPass<PassData>("present",
+			[&](FrameGraph::Builder& builder, PassData&)
+			{
+				for (auto output : kept)
+				{
+					builder.Read(output, FrameGraphAccess::kShaderResource);
+				}
+				builder.SetSideEffect();
+			}, ExecuteNothing);
+
+		return num_passes;
+	}
+
+	// cull, depth and filter of one shadow casting light, instantiated per light with its own imported shadow map
+	const FrameGraphTemplate& GetShadowTemplate()
+	{
+		static FrameGraphTemplate shadow;
+		if (shadow.GetNumPasses() == 0)
+		{
+			auto shadow_map = shadow.AddParameter("shadow_map");
+
+			auto visible = shadow.AddPass<PassData>("shadow cull",
+				[&](FrameGraph::Builder& builder, PassData& data)
+				{
+					data.output = CreateTexture(builder, 64, FrameGraphAccess::kUnorderedAccess);
+				}, ExecuteNothing).output;
+
+			auto depth = shadow.AddPass<PassData>("shadow depth",
+				[&](FrameGraph::Builder& builder, PassData& data)
+				{
+					builder.Read(visible, FrameGraphAccess::kShaderResource);
+					data.output = builder.Write(shadow_map, FrameGraphAccess::kDepthWrite);
+				}, ExecuteNothing).output;
+
+			shadow.AddPass<PassData>("shadow filter",
+				[&](FrameGraph::Builder& builder, PassData& data)
+				{
+					builder.Read(depth, FrameGraphAccess::kShaderResource);
+					data.output = builder.Write(depth, FrameGraphAccess::kUnorderedAccess);
+				}, ExecuteNothing);
+		}
+
+		return shadow;
+	}
+
+	// a shadow template instance per three passes, the setup callbacks only ran once
+	uint32_t BuildInstanced(FrameGraph& framegraph, uint32_t num_passes)
+	{
+		auto& shadow = GetShadowTemplate();
+		uint32_t num_lights = num_passes / shadow.GetNumPasses();
+
+		static std::vector<light::rhi::TextureHandle> shadow_maps;
+		light::rhi::TextureDesc desc;
+		desc.width = 1024;
+		desc.height = 1024;
+		desc.format = light::rhi::Format::D32;
+
+		while (shadow_maps.size() < num_lights)
+		{
+			shadow_maps.push_back(light::rhi::MakeHandle<light::rhi::Texture>(desc));
+		}
+
+		for (uint32_t i = 0; i < num_lights; ++i)
+		{
+			auto shadow_map = framegraph.Import<FrameGraphTexture>("shadow map", light::rhi::TextureDesc(desc), FrameGraphTexture{ shadow_maps[i] });
+			framegraph.Instantiate(shadow, { shadow_map });
+		}
+
+		return num_lights * 2;
+	}
+
+	struct IndirectPassData
+	{
+		FrameGraphHandle arguments;
+		FrameGraphHandle count;
+		FrameGraphHandle output;
+	};
+
+	constexpr uint32_t kMaxIndirectDraws = 256;
+
+	FrameGraphHandle CreateBuffer(FrameGraph::Builder& builder, uint32_t size_in_bytes)
+	{
+		light::rhi::BufferDesc desc;
+		desc.is_uav = true;
+		desc.size_in_bytes = size_in_bytes;
+
+		auto handle = builder.Create<FrameGraphBuffer>("buffer", std::move(desc));
+		return builder.Write(handle, FrameGraphAccess::kUnorderedAccess);
+	}
+
+	// gpu culling, a pass fills the draw arguments and the count of every draw pass, which records them with one indirect draw
+	uint32_t BuildIndirect(FrameGraph& framegraph, uint32_t num_passes)
+	{
+		FrameGraphHandle color = 0;
+		for (uint32_t i = 0; i + 1 < num_passes; i += 2)
+		{
+			auto& cull = framegraph.AddPass<IndirectPassData>("cull",
+				[&](FrameGraph::Builder& builder, IndirectPassData& data)
+				{
+					data.arguments = CreateBuffer(builder, kMaxIndirectDraws * sizeof(light::rhi::DrawIndexedArguments));
+					data.count = CreateBuffer(builder, sizeof(uint32_t));
+				}, [](const IndirectPassData&, FrameGraphPassResources&, light::rhi::Device*, light::rhi::CommandList*) {});
+
+			color = framegraph.AddPass<IndirectPassData>("draw",
+				[&](FrameGraph::Builder& builder, IndirectPassData& data)
+				{
+					data.arguments = builder.Read(cull.arguments, FrameGraphAccess::kIndirectArgument);
+					data.count = builder.Read(cull.count, FrameGraphAccess::kIndirectArgument);
+					data.output = i == 0 ? CreateTexture(builder, 1024) : builder.Write(color, FrameGraphAccess::kRenderTarget);
+
+					if (i + 3 >= num_passes)
+					{
+						builder.SetSideEffect();
+					}
+				},
+				[](const IndirectPassData& data, FrameGraphPassResources& resources, light::rhi::Device*, light::rhi::CommandList* command_list)
+				{
+					command_list->DrawIndexedIndirect(resources.Get<FrameGraphBuffer>(data.arguments).buffer.Get(), 0, kMaxIndirectDraws,
+						resources.Get<FrameGraphBuffer>(data.count).buffer.Get(), 0);
+				}).output;
+		}
+
+		return num_passes / 2 * 2 + 1;
+	}
+
+	// the direct queue renders, the compute queue post processes and hands its output back to the next render pass
+	uint32_t BuildAsync(FrameGraph& framegraph, uint32_t num_passes)
+	{
+		FrameGraphHandle color = 0;
+		for (uint32_t i = 0; i + 1 < num_passes; i += 2)
+		{
+			auto scene = framegraph.AddPass<PassData>("scene",
+				[&](FrameGraph::Builder& builder, PassData& data)
+				{
+					if (i > 0)
+					{
+						builder.Read(color, FrameGraphAccess::kShaderResource);
+					}
+
+					data.output = CreateTexture(builder, 512);
+				}, ExecuteNothing).output;
+
+			color = framegraph.AddPass<PassData>("post",
+				[&](FrameGraph::Builder& builder, PassData& data)
+				{
+					builder.Read(scene, FrameGraphAccess::kShaderResource);
+					data.output = CreateTexture(builder, 512, FrameGraphAccess::kUnorderedAccess);
+
+					if (i + 3 >= num_passes)
+					{
+						builder.SetSideEffect();
+					}
+				}, ExecuteNothing, light::rhi::CommandListType::kCompute).output;
+		}
+
+		return num_passes / 2 * 2;
+	}
+
+	// every submission of the last Execute waits on its own queue, right before it is submitted,
+	// for the fence values the submissions it depends on signaled
+	uint64_t CountWrongWaits(const FrameGraph& framegraph, const light::rhi::NullQueueLog& log)
+	{
+		using light::rhi::NullQueueEvent;
+
+		const auto& submissions = framegraph.GetSubmissions();
+		const auto& waits = framegraph.GetSubmissionWaits();
+		const auto& order = framegraph.GetExecutionOrder();
+		const auto& events = log.GetEvents();
+
+		auto matches = [&](size_t event, NullQueueEvent::Type type, light::rhi::CommandListType queue, const FrameGraphSubmission& signaled)
+		{
+			return event < events.size()
+				&& events[event].type == type
+				&& events[event].queue == queue
+				&& events[event].other == signaled.queue
+				&& events[event].fence_value == framegraph.GetFenceValue(order[signaled.begin]);
+		};
+
+		uint64_t num_wrong = 0;
+		size_t event = 0;
+		for (const auto& submission : submissions)
+		{
+			for (uint32_t i = submission.wait_offset; i < submission.wait_offset + submission.num_waits; ++i)
+			{
+				num_wrong += !matches(event++, NullQueueEvent::Type::kWait, submission.queue, submissions[waits[i]]);
+			}
+
+			num_wrong += !matches(event++, NullQueueEvent::Type::kSubmit, submission.queue, submission);
+		}
+
+		return num_wrong + (event != events.size());
+	}
+
+	struct Scenario
+	{
+		const char* name;
+		uint32_t (*build)(FrameGraph& framegraph, uint32_t num_passes);
+	};
+
+	struct Result
+	{
+		double setup_ns = 0;
+		double compile_ns = 0;
+		double cached_ns = 0;
+		double execute_ns = 0;
+		uint64_t allocations = 0;
+		int64_t peak_bytes = 0;
+		uint64_t estimated_peak_bytes = 0;
+		uint32_t num_resources = 0;
+		uint64_t wrong_waits = 0;
+	};
+
+	template<typename Function>
+	double MeasureNs(Function&& function)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		function();
+		auto end = std::chrono::steady_clock::now();
+		return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+	}
+
+	constexpr uint32_t kWarmupFrames = 2;
+	constexpr uint32_t kFrames = 8;
+
+	// a cold compile plans from scratch, the steady state frame rebuilds the same graph and hits the compile cache
+	Result Run(const Scenario& scenario, uint32_t num_passes, light::rhi::NullDevice* device)
+	{
+		Result result;
+		FrameGraph framegraph;
+
+		for (uint32_t frame = 0; frame < kWarmupFrames + kFrames; ++frame)
+		{
+			bool measure = frame >= kWarmupFrames;
+
+			framegraph.Clear();
+			scenario.build(framegraph, num_passes);
+			framegraph.InvalidateCompileCache();
+			auto compile = MeasureNs([&] { framegraph.Compile(); });
+			framegraph.Execute(device);
+
+			auto allocations = g_num_allocations.load();
+			auto live_bytes = g_live_bytes.load();
+			g_peak_bytes = live_bytes;
+
+			framegraph.Clear();
+			double setup = MeasureNs([&] { result.num_resources = scenario.build(framegraph, num_passes); });
+			double cached = MeasureNs([&] { framegraph.Compile(); });
+			device->GetQueueLog().ClearEvents();
+			double execute = MeasureNs([&] { framegraph.Execute(device); });
+			result.wrong_waits += CountWrongWaits(framegraph, device->GetQueueLog());
+
+			if (measure)
+			{
+				result.setup_ns += setup;
+				result.compile_ns += compile;
+				result.cached_ns += cached;
+				result.execute_ns += execute;
+				result.allocations += g_num_allocations.load() - allocations;
+				result.peak_bytes = std::max(result.peak_bytes, g_peak_bytes.load() - live_bytes);
+				result.estimated_peak_bytes = framegraph.GetMemoryEstimate().peak_bytes;
+			}
+		}
+
+		double scale = 1.0 / (static_cast<double>(kFrames) * num_passes);
+		result.setup_ns *= scale;
+		result.compile_ns *= scale;
+		result.cached_ns *= scale;
+		result.execute_ns *= scale;
+		result.allocations /= kFrames;
+
+		return result;
+	}
+
+	constexpr uint32_t kTrackedDraws = 10000;
+
+	// every draw binds a pipeline, a descriptor table, a vertex and an index buffer out of a scene sized set of objects
+	struct TrackingScene
+	{
+		std::vector<light::rhi::ResourceHandle> resources;
+		std::vector<uint32_t> binds;
+
+		TrackingScene()
+		{
+			constexpr uint32_t kNumPipelines = 16;
+			constexpr uint32_t kNumTables = 64;
+			constexpr uint32_t kNumBuffers = 256;
+
+			for (uint32_t i = 0; i < kNumPipelines; ++i)
+			{
+				resources.push_back(light::rhi::MakeHandle<light::rhi::GraphicsPipeline>(light::rhi::GraphicsPipelineDesc(), light::rhi::RenderTarget()));
+			}
+			for (uint32_t i = 0; i < kNumTables; ++i)
+			{
+				resources.push_back(light::rhi::MakeHandle<light::rhi::NullDescriptorTable>(1));
+			}
+			for (uint32_t i = 0; i < kNumBuffers * 2; ++i)
+			{
+				resources.push_back(light::rhi::MakeHandle<light::rhi::Buffer>(light::rhi::BufferDesc()));
+			}
+
+			std::mt19937 random(7);
+			for (uint32_t i = 0; i < kTrackedDraws; ++i)
+			{
+				binds.push_back(random() % kNumPipelines);
+				binds.push_back(kNumPipelines + random() % kNumTables);
+				binds.push_back(kNumPipelines + kNumTables + random() % kNumBuffers);
+				binds.push_back(kNumPipelines + kNumTables + kNumBuffers + random() % kNumBuffers);
+			}
+		}
+	};
+
+	struct TrackingResult
+	{
+		double record_ns = 0;
+		uint64_t retains = 0;
+	};
+
+	// what a command list pays to keep its bound resources alive over one recording and reset, every retain is an atomic AddRef and Release
+	template<typename Track, typename Reset>
+	TrackingResult RunTracking(const TrackingScene& scene, Track&& track, Reset&& reset)
+	{
+		TrackingResult result;
+
+		for (uint32_t frame = 0; frame < kWarmupFrames + kFrames; ++frame)
+		{
+			uint64_t retains = 0;
+			double record = MeasureNs([&]
+			{
+				for (auto bind : scene.binds)
+				{
+					track(scene.resources[bind].Get());
+				}
+				retains = reset();
+			});
+
+			if (frame >= kWarmupFrames)
+			{
+				result.record_ns += record;
+				result.retains = retains;
+			}
+		}
+
+		result.record_ns /= static_cast<double>(kFrames) * kTrackedDraws;
+		return result;
+	}
+
+	constexpr uint32_t kQueueDraws = 65536;
+	constexpr uint32_t kQueueBuckets = 4;
+	constexpr uint32_t kQueueLayouts = 8;
+	constexpr uint32_t kQueuePipelines = 256;
+	constexpr uint32_t kQueueMaterials = 1024;
+	constexpr uint32_t kQueueMeshes = 64;
+	constexpr uint32_t kQueueConstants = 4;
+
+	// the draws of a scene in submission order, each with a pipeline, a material and a mesh out of scene sized sets and its own constants
+	struct QueueScene
+	{
+		std::vector<light::rhi::GraphicsPipelineHandle> pipelines;
+		std::vector<light::rhi::DescriptorTableHandle> materials;
+		std::vector<light::rhi::BufferHandle> buffers;
+		std::vector<uint32_t> constants;
+		std::vector<light::rhi::DrawItem> items;
+		std::vector<float> depths;
+
+		QueueScene()
+		{
+			std::vector<light::rhi::BindingLayoutHandle> layouts;
+			for (uint32_t i = 0; i < kQueueLayouts; ++i)
+			{
+				layouts.push_back(light::rhi::MakeHandle<light::rhi::BindingLayout>(2u));
+			}
+
+			for (uint32_t i = 0; i < kQueuePipelines; ++i)
+			{
+				light::rhi::GraphicsPipelineDesc desc;
+				desc.binding_layout = layouts[i % kQueueLayouts];
+				pipelines.push_back(light::rhi::MakeHandle<light::rhi::GraphicsPipeline>(desc, light::rhi::RenderTarget()));
+			}
+
+			for (uint32_t i = 0; i < kQueueMaterials; ++i)
+			{
+				materials.push_back(light::rhi::MakeHandle<light::rhi::NullDescriptorTable>(4u));
+			}
+
+			for (uint32_t i = 0; i < kQueueMeshes * 2; ++i)
+			{
+				buffers.push_back(light::rhi::MakeHandle<light::rhi::Buffer>(light::rhi::BufferDesc()));
+			}
+
+			std::mt19937 random(7);
+			constants.resize(kQueueDraws * kQueueConstants);
+			for (uint32_t i = 0; i < kQueueDraws; ++i)
+			{
+				auto mesh = random() % kQueueMeshes;
+
+				light::rhi::DrawItem item;
+				item.pipeline = pipelines[random() % kQueuePipelines].Get();
+				item.descriptor_table = materials[random() % kQueueMaterials].Get();
+				item.vertex_buffer = buffers[mesh * 2].Get();
+				item.index_buffer = buffers[mesh * 2 + 1].Get();
+				item.constants_parameter = 1;
+				item.num_constants = kQueueConstants;
+				item.constants = constants.data() + i * kQueueConstants;
+				item.index_count = 36;
+
+				items.push_back(item);
+				depths.push_back(static_cast<float>(random()) / static_cast<float>(std::mt19937::max()));
+			}
+		}
+	};
+
+	struct QueueResult
+	{
+		double submit_ns = 0;
+		double flush_ns = 0;
+		uint64_t pipeline_binds = 0;
+		uint64_t table_binds = 0;
+	};
+
+	// the draws submitted round robin into the buckets and flushed sorted into one list, times are ns per draw
+	QueueResult RunRenderQueue(const QueueScene& scene, light::rhi::NullDevice& device)
+	{
+		QueueResult result;
+
+		light::rhi::RenderQueue queue(kQueueBuckets);
+		auto command_list = device.GetCommandList(light::rhi::CommandListType::kDirect);
+		auto* null_command_list = static_cast<light::rhi::NullCommandList*>(command_list.Get());
+
+		for (uint32_t frame = 0; frame < kWarmupFrames + kFrames; ++frame)
+		{
+			double submit = MeasureNs([&]
+			{
+				for (uint32_t i = 0; i < kQueueDraws; ++i)
+				{
+					queue.Submit(i % kQueueBuckets, scene.items[i], scene.depths[i]);
+				}
+			});
+
+			auto pipeline_binds = null_command_list->GetNumPipelineBinds();
+			auto table_binds = null_command_list->GetNumDescriptorTableBinds();
+			double flush = MeasureNs([&] { queue.Flush(command_list.Get()); });
+
+			if (frame >= kWarmupFrames)
+			{
+				result.submit_ns += submit;
+				result.flush_ns += flush;
+				result.pipeline_binds = null_command_list->GetNumPipelineBinds() - pipeline_binds;
+				result.table_binds = null_command_list->GetNumDescriptorTableBinds() - table_binds;
+			}
+		}
+
+		result.submit_ns /= static_cast<double>(kFrames) * kQueueDraws;
+		result.flush_ns /= static_cast<double>(kFrames) * kQueueDraws;
+		return result;
+	}
+}
+
+int main()
+{
+	const Scenario scenarios[] =
+	{
+		{ "chain", BuildChain },
+		{ "fan", BuildFan },
+		{ "random", BuildRandom },
+		{ "culled", BuildCulled },
+		{ "instanced", BuildInstanced },
+		{ "indirect", BuildIndirect },
+		{ "async", BuildAsync },
+	};
+
+	light::rhi::NullDevice device;
+
+	// times are ns per pass, allocations and peak heap bytes are per steady state frame
+	std::printf("%-9s %7s %9s %9s %9s %9s %9s %11s %11s %13s\n",
+		"graph", "passes", "resources", "setup", "compile", "cached", "execute", "allocs", "peak heap", "estimated");
+
+	uint64_t wrong_waits = 0;
+	for (auto& scenario : scenarios)
+	{
+		for (uint32_t num_passes = 125; num_passes <= 1000; num_passes *= 2)
+		{
+			auto result = Run(scenario, num_passes, &device);
+			wrong_waits += result.wrong_waits;
+
+			std::printf("%-9s %7u %9u %9.1f %9.1f %9.1f %9.1f %11llu %11lld %13llu\n",
+				scenario.name, num_passes, result.num_resources,
+				result.setup_ns, result.compile_ns, result.cached_ns, result.execute_ns,
+				static_cast<unsigned long long>(result.allocations),
+				static_cast<long long>(result.peak_bytes),
+				static_cast<unsigned long long>(result.estimated_peak_bytes));
+		}
+	}
+
+	std::printf("\n%llu gpu objects created, %llu descriptor tables baked, %llu submissions, %llu indirect draws, %llu skipped\n",
+		static_cast<unsigned long long>(device.GetNumCreatedObjects()),
+		static_cast<unsigned long long>(device.GetNumDescriptorTables()),
+		static_cast<unsigned long long>(device.GetNumSubmissions()),
+		static_cast<unsigned long long>(device.GetNumIndirectDraws()),
+		static_cast<unsigned long long>(device.GetNumIndirectDraws(true)));
+
+	// a wait out of order or for a value not signaled yet, and transitions the compute and copy queues can't do
+	std::printf("%llu queue waits, %llu invalid, %llu not matching the plan, %llu barriers invalid on their queue\n",
+		static_cast<unsigned long long>(device.GetQueueLog().GetNumWaits()),
+		static_cast<unsigned long long>(device.GetQueueLog().GetNumInvalidWaits()),
+		static_cast<unsigned long long>(wrong_waits),
+		static_cast<unsigned long long>(device.GetNumInvalidBarriers()));
+
+	// resource tracking of one list, times are ns per draw
+	TrackingScene scene;
+
+	std::vector<light::rhi::ResourceHandle> per_bind;
+	auto retained = RunTracking(scene,
+		[&](light::rhi::Resource* resource) { per_bind.emplace_back(resource); },
+		[&]() { auto retains = per_bind.size(); per_bind.clear(); return retains; });
+
+	light::rhi::TrackedResources tracked;
+	auto deduplicated = RunTracking(scene,
+		[&](light::rhi::Resource* resource) { tracked.Track(resource); },
+		[&]() { auto retains = tracked.GetNumResources(); tracked.Clear(); return retains; });
+
+	std::printf("\n%-13s %7s %9s %9s\n", "tracking", "draws", "retains", "record");
+	std::printf("%-13s %7u %9llu %9.1f\n", "per bind", kTrackedDraws, static_cast<unsigned long long>(retained.retains), retained.record_ns);
+	std::printf("%-13s %7u %9llu %9.1f\n", "deduplicated", kTrackedDraws, static_cast<unsigned long long>(deduplicated.retains), deduplicated.record_ns);
+
+	// a sorted flush binds every pipeline once, times are ns per draw
+	QueueScene queue_scene;
+	auto sorted = RunRenderQueue(queue_scene, device);
+
+	std::printf("\n%-13s %7s %9s %9s %9s %9s\n", "render queue", "draws", "submit", "flush", "pipelines", "tables");
+	std::printf("%-13s %7u %9.1f %9.1f %9llu %9llu\n", "sorted", kQueueDraws, sorted.submit_ns, sorted.flush_ns,
+		static_cast<unsigned long long>(sorted.pipeline_binds), static_cast<unsigned long long>(sorted.table_binds));
+
+	return 0;
+}
\ No newline at end of file
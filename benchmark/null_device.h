@@ -0,0 +1,359 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "rhi/device.h"
+
+namespace light::rhi
+{
+	// Records nothing, lets the frame graph run its whole execute path without a gpu. Indirect draws still check their argument layouts and are counted,
+	// transitions are checked against the states the queue of the list may use
+	class NullCommandList final : public CommandList
+	{
+	public:
+		NullCommandList(CommandListType type, CommandQueue* queue)
+			: CommandList(type, queue)
+		{
+		}
+
+		void TransitionBarrier(Buffer*, ResourceStates, uint32_t, bool, bool) override {}
+		void TransitionBarrier(Texture*, ResourceStates, uint32_t, bool, bool) override {}
+		void ResourceBarriers(uint32_t num_barriers, const ResourceBarrier* barriers) override
+		{
+			// the compute and copy queues can't transition from or to a graphics state
+			auto states = ResourceStates::kVertexAndConstantBuffer | ResourceStates::kUnorderedAccess | ResourceStates::kNonPixelShaderResource
+				| ResourceStates::kIndirectArgument | ResourceStates::kCopyDest | ResourceStates::kCopySource;
+			if (type_ == CommandListType::kCopy)
+			{
+				states = ResourceStates::kCopyDest | ResourceStates::kCopySource;
+			}
+
+			for (uint32_t i = 0; type_ != CommandListType::kDirect && i < num_barriers; ++i)
+			{
+				if (((barriers[i].state_before | barriers[i].state_after) & ~states) != 0)
+				{
+					++num_invalid_barriers_;
+				}
+			}
+		}
+		void ClearTexture(Texture*, const float*) override {}
+		void ClearTexture(Texture*, uint32_t, uint32_t, uint32_t, const float*) override {}
+		void ClearDepthStencilTexture(Texture*, ClearFlags, float, uint8_t) override {}
+		void ClearDepthStencilTexture(Texture*, uint32_t, uint32_t, uint32_t, ClearFlags, float, uint8_t) override {}
+		void WriteBuffer(Buffer*, const uint8_t*, uint64_t, uint64_t) override {}
+		void SetGraphicsDynamicConstantBuffer(uint32_t, size_t, const void*) override {}
+		void SetGraphics32BitConstants(uint32_t, uint32_t, const void*) override {}
+		void SetBufferView(uint32_t, Buffer*, uint32_t, ResourceStates) override {}
+		void SetConstantBufferView(uint32_t, uint32_t, Buffer*, ResourceStates) override {}
+		void SetStructuredBufferView(uint32_t, uint32_t, Buffer*, uint32_t, ResourceStates) override {}
+		void SetStructuredBufferView(uint32_t, uint32_t, Buffer*, uint32_t, uint32_t, ResourceStates) override {}
+		void SetUnoderedAccessBufferView(uint32_t, uint32_t, Buffer*, uint32_t, ResourceStates) override {}
+		void SetUnoderedAccessBufferView(uint32_t, uint32_t, Buffer*, uint32_t, uint32_t, ResourceStates) override {}
+		void SetShaderResourceView(uint32_t, uint32_t, Texture*, Format, TextureDimension, uint32_t, uint32_t, uint32_t, uint32_t, ResourceStates) override {}
+		void SetGraphicsDescriptorTable(uint32_t, DescriptorTable*) override { ++num_descriptor_table_binds_; }
+		void SetGraphicsPipeline(GraphicsPipeline*) override { ++num_pipeline_binds_; }
+		void SetPrimitiveTopology(PrimitiveTopology) override {}
+		void SetVertexBuffers(uint32_t, uint32_t, Buffer* const*, const uint32_t*) override {}
+		void SetIndexBuffer(Buffer*) override {}
+		void SetRenderTarget(const RenderTarget&) override {}
+		void SetViewports(uint32_t, const Viewport*) override {}
+		void SetScissorRects(uint32_t, const Rect*) override {}
+		void ExecuteCommandList() override {}
+		bool Close(CommandList*) override { return false; }
+		void Close() override {}
+		void Reset() override {}
+		void DrawIndexed(uint32_t, uint32_t, uint32_t, int32_t, uint32_t) override {}
+		void Draw(uint32_t, uint32_t, uint32_t, uint32_t) override {}
+
+		void DrawIndirect(Buffer* argument_buffer, uint64_t argument_offset, uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset) override
+		{
+			CountIndirectDraw(CheckIndirectArguments(argument_buffer, argument_offset, sizeof(DrawArguments), max_draw_count, count_buffer, count_offset));
+		}
+
+		void DrawIndexedIndirect(Buffer* argument_buffer, uint64_t argument_offset, uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset) override
+		{
+			CountIndirectDraw(CheckIndirectArguments(argument_buffer, argument_offset, sizeof(DrawIndexedArguments), max_draw_count, count_buffer, count_offset));
+		}
+
+		uint64_t GetNumIndirectDraws() const { return num_indirect_draws_; }
+
+		// indirect draws skipped because their arguments were out of bounds
+		uint64_t GetNumSkippedIndirectDraws() const { return num_skipped_indirect_draws_; }
+
+		// transitions a real compute or copy list would have rejected
+		uint64_t GetNumInvalidBarriers() const { return num_invalid_barriers_; }
+
+		uint64_t GetNumPipelineBinds() const { return num_pipeline_binds_; }
+		uint64_t GetNumDescriptorTableBinds() const { return num_descriptor_table_binds_; }
+	protected:
+		void TrackResource(Resource*) override {}
+		void FlushResourceBarriers() override {}
+	private:
+		void CountIndirectDraw(bool valid)
+		{
+			++(valid ? num_indirect_draws_ : num_skipped_indirect_draws_);
+		}
+
+		uint64_t num_indirect_draws_ = 0;
+		uint64_t num_skipped_indirect_draws_ = 0;
+		uint64_t num_invalid_barriers_ = 0;
+		uint64_t num_pipeline_binds_ = 0;
+		uint64_t num_descriptor_table_binds_ = 0;
+	};
+
+	class NullDescriptorTable final : public DescriptorTable
+	{
+	public:
+		explicit NullDescriptorTable(uint32_t num_descriptors)
+			: DescriptorTable(num_descriptors)
+		{
+		}
+
+		void SetShaderResourceView(uint32_t, Texture*, Format, TextureDimension, uint32_t, uint32_t, uint32_t, uint32_t) override {}
+		void SetUnorderedAccessView(uint32_t, Texture*, Format, TextureDimension, uint32_t, uint32_t, uint32_t) override {}
+		void SetStructuredBufferView(uint32_t, Buffer*, uint32_t, uint32_t) override {}
+		void SetUnoderedAccessBufferView(uint32_t, Buffer*, uint32_t, uint32_t) override {}
+	};
+
+	// What the queues of a NullDevice were asked to do, in call order
+	struct NullQueueEvent
+	{
+		enum class Type : uint8_t
+		{
+			kSubmit,		// fence_value is the value the submission signals
+			kSignal,
+			kWait,			// gpu side, queue waits until other reached fence_value
+			kCpuWait,		// the cpu waits until queue reached fence_value
+		};
+
+		Type type;
+		CommandListType queue;
+		CommandListType other;
+		uint64_t fence_value;
+	};
+
+	// The submissions, signals and waits of every queue of a device. The cpu submits in order, so a wait has to be for a value
+	// the other queue already signaled, a real gpu would hang on a later one and a wait for 0 orders nothing
+	class NullQueueLog
+	{
+	public:
+		void Signal(CommandListType queue, uint64_t fence_value, bool submit)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			events_.push_back({ submit ? NullQueueEvent::Type::kSubmit : NullQueueEvent::Type::kSignal, queue, queue, fence_value });
+			signaled_[static_cast<uint32_t>(queue)] = fence_value;
+		}
+
+		void Wait(CommandListType queue, CommandListType other, uint64_t fence_value)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			events_.push_back({ NullQueueEvent::Type::kWait, queue, other, fence_value });
+			++num_waits_;
+			if (other == queue || fence_value == 0 || fence_value > signaled_[static_cast<uint32_t>(other)])
+			{
+				++num_invalid_waits_;
+			}
+		}
+
+		void CpuWait(CommandListType queue, uint64_t fence_value)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			events_.push_back({ NullQueueEvent::Type::kCpuWait, queue, queue, fence_value });
+			if (fence_value > signaled_[static_cast<uint32_t>(queue)])
+			{
+				++num_invalid_waits_;
+			}
+		}
+
+		// only while nothing submits, the counts and fence values keep going
+		const std::vector<NullQueueEvent>& GetEvents() const { return events_; }
+		void ClearEvents() { events_.clear(); }
+
+		uint64_t GetNumWaits() const { return num_waits_; }
+		uint64_t GetNumInvalidWaits() const { return num_invalid_waits_; }
+	private:
+		std::mutex mutex_;
+		std::vector<NullQueueEvent> events_;
+		std::array<uint64_t, static_cast<size_t>(CommandListType::kCopy) + 1> signaled_{};
+		uint64_t num_waits_ = 0;
+		uint64_t num_invalid_waits_ = 0;
+	};
+
+	class NullCommandQueue final : public CommandQueue
+	{
+	public:
+		NullCommandQueue(CommandListType type, NullQueueLog* log)
+			: CommandQueue(type)
+			, log_(log)
+			, next_command_list_(0)
+			, fence_value_(0)
+			, num_submissions_(0)
+		{
+			for (auto& command_list : command_lists_)
+			{
+				command_list = MakeHandle<NullCommandList>(type, this);
+			}
+		}
+
+		// hands out a fixed ring of lists, keeps the device out of the allocation counts
+		CommandListHandle GetCommandList() override
+		{
+			return command_lists_[next_command_list_++ % command_lists_.size()];
+		}
+
+		uint64_t ExecuteCommandList(CommandList* command_list) override
+		{
+			return ExecuteCommandLists(1, &command_list);
+		}
+
+		uint64_t ExecuteCommandLists(uint64_t, CommandList* const*) override
+		{
+			++num_submissions_;
+			auto fence_value = ++fence_value_;
+			log_->Signal(command_list_type_, fence_value, true);
+			return fence_value;
+		}
+
+		uint64_t Signal() override
+		{
+			auto fence_value = ++fence_value_;
+			log_->Signal(command_list_type_, fence_value, false);
+			return fence_value;
+		}
+
+		// every queue of the device is a NullCommandQueue
+		void Wait(CommandQueue* queue, uint64_t fence_value) override
+		{
+			log_->Wait(command_list_type_, static_cast<NullCommandQueue*>(queue)->command_list_type_, fence_value);
+		}
+
+		bool IsFenceCompleted(uint64_t) override { return true; }
+		void WaitForFenceValue(uint64_t fence_value) override { log_->CpuWait(command_list_type_, fence_value); }
+		void Flush() override {}
+		void ProcessCommandLists() override {}
+
+		uint64_t GetNumSubmissions() const { return num_submissions_; }
+
+		// over the lists of the queue, only while no list is recording
+		uint64_t GetNumIndirectDraws(bool skipped = false) const
+		{
+			uint64_t num_draws = 0;
+			for (auto& command_list : command_lists_)
+			{
+				auto* null_command_list = static_cast<const NullCommandList*>(command_list.Get());
+				num_draws += skipped ? null_command_list->GetNumSkippedIndirectDraws() : null_command_list->GetNumIndirectDraws();
+			}
+			return num_draws;
+		}
+
+		uint64_t GetNumInvalidBarriers() const
+		{
+			uint64_t num_barriers = 0;
+			for (auto& command_list : command_lists_)
+			{
+				num_barriers += static_cast<const NullCommandList*>(command_list.Get())->GetNumInvalidBarriers();
+			}
+			return num_barriers;
+		}
+	private:
+		NullQueueLog* log_;
+		std::array<CommandListHandle, 256> command_lists_;
+		std::atomic_uint32_t next_command_list_;
+		std::atomic_uint64_t fence_value_;
+		std::atomic_uint64_t num_submissions_;
+	};
+
+	class NullDevice final : public Device
+	{
+	public:
+		NullDevice()
+		{
+			for (uint32_t i = 0; i < queues_.size(); ++i)
+			{
+				queues_[i] = MakeHandle<NullCommandQueue>(static_cast<CommandListType>(i), &queue_log_);
+			}
+		}
+
+		GraphicsApi GetGraphicsApi() const override { return GraphicsApi::kNone; }
+
+		ShaderHandle CreateShader(ShaderType, const std::string&, const std::string&, const std::string&) override { return nullptr; }
+
+		BufferHandle CreateBuffer(BufferDesc desc) override
+		{
+			++num_created_objects_;
+			return MakeHandle<Buffer>(desc);
+		}
+
+		TextureHandle CreateTexture(const TextureDesc& desc) override
+		{
+			++num_created_objects_;
+			return MakeHandle<Texture>(desc);
+		}
+
+		TextureHandle CreateTextureForNative(const TextureDesc& desc, void*) override { return CreateTexture(desc); }
+		InputLayoutHandle CreateInputLayout(std::vector<VertexAttributeDesc>) override { return nullptr; }
+		GraphicsPipelineHandle CreateGraphicsPipeline(GraphicsPipelineDesc, const RenderTarget&) override { return nullptr; }
+
+		DescriptorTableHandle CreateDescriptorTable(uint32_t num_descriptors) override
+		{
+			++num_descriptor_tables_;
+			return MakeHandle<NullDescriptorTable>(num_descriptors);
+		}
+
+		CommandQueue* GetCommandQueue(CommandListType type) override
+		{
+			return queues_[static_cast<uint32_t>(type)];
+		}
+
+		CommandListHandle GetCommandList(CommandListType type) override
+		{
+			return queues_[static_cast<uint32_t>(type)]->GetCommandList();
+		}
+
+		void Flush() override {}
+
+		uint64_t GetNumCreatedObjects() const { return num_created_objects_; }
+
+		uint64_t GetNumDescriptorTables() const { return num_descriptor_tables_; }
+
+		uint64_t GetNumSubmissions() const
+		{
+			uint64_t num_submissions = 0;
+			for (auto& queue : queues_)
+			{
+				num_submissions += queue->GetNumSubmissions();
+			}
+			return num_submissions;
+		}
+
+		uint64_t GetNumIndirectDraws(bool skipped = false) const
+		{
+			uint64_t num_draws = 0;
+			for (auto& queue : queues_)
+			{
+				num_draws += queue->GetNumIndirectDraws(skipped);
+			}
+			return num_draws;
+		}
+
+		uint64_t GetNumInvalidBarriers() const
+		{
+			uint64_t num_barriers = 0;
+			for (auto& queue : queues_)
+			{
+				num_barriers += queue->GetNumInvalidBarriers();
+			}
+			return num_barriers;
+		}
+
+		NullQueueLog& GetQueueLog() { return queue_log_; }
+	private:
+		NullQueueLog queue_log_;
+		std::array<Handle<NullCommandQueue>, static_cast<size_t>(CommandListType::kCopy) + 1> queues_;
+		uint64_t num_created_objects_ = 0;
+		uint64_t num_descriptor_tables_ = 0;
+	};
+}
\ No newline at end of file
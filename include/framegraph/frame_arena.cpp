@@ -0,0 +1,84 @@
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "rhi/base.h"
+
+namespace light::fg
+{
+	FrameArena::FrameArena(size_t block_size)
+		: block_size_(block_size)
+		, block_index_(0)
+		, offset_(0)
+		, used_bytes_(0)
+		, destructors_(nullptr)
+	{
+	}
+
+	FrameArena::~FrameArena()
+	{
+		Reset();
+	}
+
+	void* FrameArena::Allocate(size_t size, size_t alignment)
+	{
+		while (block_index_ < blocks_.size())
+		{
+			auto& block = blocks_[block_index_];
+
+			auto base = reinterpret_cast<uintptr_t>(block.memory.get());
+			auto begin = rhi::Align<uintptr_t>(base + offset_, alignment) - base;
+			if (begin + size <= block.size)
+			{
+				offset_ = begin + size;
+				used_bytes_ += size;
+				return block.memory.get() + begin;
+			}
+
+			++block_index_;
+			offset_ = 0;
+		}
+
+		// oversized allocations get a block of their own
+		auto block_size = std::max(block_size_, size + alignment);
+		blocks_.push_back({ std::make_unique<std::byte[]>(block_size), block_size });
+
+		return Allocate(size, alignment);
+	}
+
+	std::string_view FrameArena::CopyString(std::string_view str)
+	{
+		if (str.empty())
+		{
+			return {};
+		}
+
+		auto* data = static_cast<char*>(Allocate(str.size(), alignof(char)));
+		std::memcpy(data, str.data(), str.size());
+		return { data, str.size() };
+	}
+
+	void FrameArena::Reset()
+	{
+		for (auto* destructor = destructors_; destructor; destructor = destructor->next)
+		{
+			destructor->destroy(destructor->object);
+		}
+
+		destructors_ = nullptr;
+		block_index_ = 0;
+		offset_ = 0;
+		used_bytes_ = 0;
+	}
+
+	size_t FrameArena::GetCapacity() const
+	{
+		size_t capacity = 0;
+		for (auto& block : blocks_)
+		{
+			capacity += block.size;
+		}
+		return capacity;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace light::fg
+{
+	// Linear allocator for everything built between two FrameGraph::Clear calls.
+	// Reset keeps the blocks, a frame that fits into the previous one does not touch the heap.
+	class FrameArena
+	{
+	public:
+		static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+		explicit FrameArena(size_t block_size = kDefaultBlockSize);
+		~FrameArena();
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena(FrameArena&&) = delete;
+
+		FrameArena& operator=(const FrameArena&) = delete;
+		FrameArena& operator=(FrameArena&&) = delete;
+
+		void* Allocate(size_t size, size_t alignment);
+
+		// objects with a non trivial destructor are destroyed by Reset, in reverse order
+		template<typename T, typename... Args>
+		T* New(Args&&... args)
+		{
+			if constexpr (std::is_trivially_destructible_v<T>)
+			{
+				return new(Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			}
+			else
+			{
+				auto* destructor = static_cast<Destructor*>(Allocate(sizeof(Destructor), alignof(Destructor)));
+				auto* object = new(Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+				destructor->object = object;
+				destructor->destroy = [](void* object) { static_cast<T*>(object)->~T(); };
+				destructor->next = destructors_;
+				destructors_ = destructor;
+
+				return object;
+			}
+		}
+
+		std::string_view CopyString(std::string_view str);
+
+		void Reset();
+
+		// bytes handed out since the last Reset
+		size_t GetUsedBytes() const { return used_bytes_; }
+
+		size_t GetCapacity() const;
+	private:
+		struct Destructor
+		{
+			void* object;
+			void (*destroy)(void*);
+			Destructor* next;
+		};
+
+		struct Block
+		{
+			std::unique_ptr<std::byte[]> memory;
+			size_t size;
+		};
+
+		std::vector<Block> blocks_;
+		size_t block_size_;
+		size_t block_index_;
+		size_t offset_;
+		size_t used_bytes_;
+		Destructor* destructors_;
+	};
+
+	// Lets std containers grow inside a FrameArena, memory is only released by the arena Reset
+	template<typename T>
+	struct FrameArenaAllocator
+	{
+		using value_type = T;
+
+		FrameArenaAllocator(FrameArena& arena) noexcept
+			: arena(&arena)
+		{
+		}
+
+		template<typename U>
+		FrameArenaAllocator(const FrameArenaAllocator<U>& other) noexcept
+			: arena(other.arena)
+		{
+		}
+
+		T* allocate(size_t n)
+		{
+			return static_cast<T*>(arena->Allocate(n * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T*, size_t) noexcept
+		{
+		}
+
+		template<typename U>
+		bool operator==(const FrameArenaAllocator<U>& other) const { return arena == other.arena; }
+
+		template<typename U>
+		bool operator!=(const FrameArenaAllocator<U>& other) const { return arena != other.arena; }
+
+		FrameArena* arena;
+	};
+
+	template<typename T>
+	using FrameArenaVector = std::vector<T, FrameArenaAllocator<T>>;
+}
\ No newline at end of file
@@ -1,6 +1,14 @@
 #include "framegraph.h"
 
 #include <stack>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <thread>
+#include <unordered_map>
 
 namespace light::fg
 {
@@ -10,12 +18,29 @@ namespace light::fg
 	{
 	}
 
-	FrameGraphHandle FrameGraph::Builder::Read(FrameGraphHandle handle)
+	FrameGraphHandle FrameGraph::Builder::Read(FrameGraphHandle handle, FrameGraphAccess access)
 	{
-		return pass_node_.Read(handle);
+		return pass_node_.Read(handle, access, framegraph_.resource_nodes_[handle].range);
 	}
 
-	FrameGraphHandle FrameGraph::Builder::Write(FrameGraphHandle handle)
+	FrameGraphHandle FrameGraph::Builder::Read(FrameGraphHandle handle, FrameGraphAccess access, const FrameGraphSubresourceRange& range)
+	{
+		// subresources the version doesn't cover were last written by earlier versions
+		const auto& resource_node = framegraph_.resource_nodes_[handle];
+		if (!resource_node.range.Contains(range))
+		{
+			framegraph_.ReadVersions(pass_node_, resource_node.previous, range);
+		}
+
+		return pass_node_.Read(handle, access, range);
+	}
+
+	FrameGraphHandle FrameGraph::Builder::Write(FrameGraphHandle handle, FrameGraphAccess access)
+	{
+		return Write(handle, access, framegraph_.resource_nodes_[handle].range);
+	}
+
+	FrameGraphHandle FrameGraph::Builder::Write(FrameGraphHandle handle, FrameGraphAccess access, const FrameGraphSubresourceRange& range)
 	{
 		// дĵԴpassnodeЧ
 		if (framegraph_.GetFrameGraphResource(handle).IsImported())
@@ -24,19 +49,19 @@ namespace light::fg
 		}
 
 		// ǷԼresource
-		if (pass_node_.HasCreate(handle))
+		if (pass_node_.HasCreate(handle) && framegraph_.resource_nodes_[handle].range == range)
 		{
-			pass_node_.Write(handle);
+			pass_node_.Write(handle, access);
 		}
 		else 
 		{
-			// ȷpass_nodeжȡresource
-			pass_node_.Read(handle);
+			// ȷpass_nodeжȡresource, only for the order, the written range has its own usage
+			framegraph_.ReadVersions(pass_node_, handle, range);
 
 			// µresource_node,д
-			handle = framegraph_.CreateNewVersionNode(handle);
+			handle = framegraph_.CreateNewVersionNode(handle, range);
 
-			pass_node_.Write(handle);
+			pass_node_.Write(handle, access);
 		}
 
 		return handle;
@@ -46,15 +71,38 @@ namespace light::fg
 		pass_node_.SideEffect();
 	}
 
+	void FrameGraph::Builder::SetReadback()
+	{
+		pass_node_.readback = true;
+	}
+
 	void FrameGraph::Clear()
 	{
 		resources_.clear();
 		pass_nodes_.clear();
 		resource_nodes_.clear();
+		pass_stats_.clear();
+		num_instances_ = 0;
+
+		history_uses_.clear();
+		for (auto& history : histories_)
+		{
+			history.frame.reset();
+		}
+
+		arena_.Reset();
 	}
 
 	void FrameGraph::Compile()
 	{
+		auto hash = ComputeStructureHash();
+		if (compiled_graph_.valid && compiled_graph_.hash == hash)
+		{
+			RestoreCompiledGraph();
+			compile_cached_ = true;
+			return;
+		}
+
 		for (auto& pass_node : pass_nodes_)
 		{
 			pass_node.ref_count = pass_node.writes.size();
@@ -93,6 +141,11 @@ namespace light::fg
 			{
 				continue;
 			}
+
+			if (--producer->ref_count > 0)
+			{
+				continue;
+			}
 			
 			for (auto& handle : producer->reads)
 			{
@@ -103,71 +156,461 @@ namespace light::fg
 			}
 		}
 
-		//lifetime
+		execution_order_.clear();
 		for (auto& pass_node : pass_nodes_)
 		{
-			for (auto handle : pass_node.creates)
+			if (pass_node.CanExecute())
 			{
-				GetFrameGraphResource(handle).producer = &pass_node;
+				execution_order_.push_back(pass_node.id);
 			}
+		}
 
-			for (auto handle : pass_node.reads)
+		if (scheduling_enabled_)
+		{
+			ScheduleExecutionOrder();
+		}
+		else
+		{
+			schedule_stats_.declaration_order = execution_order_;
+			schedule_stats_.num_declaration_barriers = CountOrderBarriers();
+			schedule_stats_.num_scheduled_barriers = schedule_stats_.num_declaration_barriers;
+		}
+
+		if (submission_batching_enabled_)
+		{
+			BatchSubmissions();
+		}
+
+		AssignResourceLifetimes();
+
+		PlanResourceLifetimes();
+
+		EstimateMemory();
+		memory_estimate_.unserialized_peak_bytes = memory_estimate_.peak_bytes;
+		memory_estimate_.num_serialized_passes = 0;
+
+		if (IsOverMemoryBudget() && budget_policy_ == FrameGraphBudgetPolicy::kSerialize)
+		{
+			// pooled objects only go to resources of the same desc, so the live bytes undercount the estimate.
+			// a lower limit serializes more of the order, down to every pass that allocates
+			auto order = execution_order_;
+			for (uint64_t step = 4;; --step)
 			{
-				GetFrameGraphResource(handle).last = &pass_node;
+				execution_order_ = order;
+				ScheduleForMemory(memory_budget_ * step / 4);
+				AssignResourceLifetimes();
+				PlanResourceLifetimes();
+				EstimateMemory();
+
+				if (!IsOverMemoryBudget() || step == 0)
+				{
+					break;
+				}
 			}
+		}
 
-			for (auto handle : pass_node.writes)
+		PlanBarriers();
+
+		PlanSplitBarriers();
+
+		PlanSubmissions();
+
+		PlanRenderPasses();
+
+		PlanDescriptorTables();
+
+		SaveCompiledGraph(hash);
+		compile_cached_ = false;
+	}
+
+	void FrameGraph::Execute(rhi::Device* device)
+	{
+		if (IsOverMemoryBudget())
+		{
+			throw FrameGraphBudgetExceeded(GetMemoryReport());
+		}
+
+		resource_pool_.SetDevice(device);
+
+		RealizeHistories(device);
+
+		// realize resources up front in lifetime order, the recording threads only read them.
+		// a resource taking over an object gets it back from the pool, which hands the last released object out first
+		for (auto id : execution_order_)
+		{
+			uint32_t num_reused = 0;
+			for (uint32_t i = create_offsets_[id]; i < create_offsets_[id + 1]; ++i)
 			{
-				GetFrameGraphResource(handle).last = &pass_node;
+				if (create_predecessors_[i] != ~0u)
+				{
+					resources_[create_predecessors_[i]].Destroy(resource_pool_);
+					++num_reused;
+				}
+
+				auto& resource = resources_[create_rids_[i]];
+				resource.Create(resource_pool_);
+			}
+
+			pass_stats_[id].num_created = create_offsets_[id + 1] - create_offsets_[id];
+			pass_stats_[id].num_reused = num_reused;
+		}
+
+		// FillBarrier doubles as the lookup of the rhi texture behind an attachment
+		render_targets_.assign(render_passes_.size(), rhi::RenderTarget());
+		for (uint32_t i = 0; i < render_passes_.size(); ++i)
+		{
+			const auto& render_pass = render_passes_[i];
+			for (uint32_t j = render_pass.attachment_offset; j < render_pass.attachment_offset + render_pass.num_attachments; ++j)
+			{
+				const auto& attachment = render_pass_attachments_[j];
+
+				rhi::ResourceBarrier barrier;
+				if (!resources_[attachment.rid].FillBarrier(barrier) || !barrier.texture)
+				{
+					continue;
+				}
+
+				if (attachment.range.IsWhole(resources_[attachment.rid].GetSubresources()))
+				{
+					render_targets_[i].AttacthAttachment(attachment.point, barrier.texture);
+				}
+				else
+				{
+					render_targets_[i].AttacthAttachment(attachment.point, barrier.texture, attachment.range.first_mip, attachment.range.first_slice);
+				}
+			}
+		}
+
+		BakeDescriptorTables(device);
+
+		// every submission is split into contiguous chunks, one command list per chunk
+		struct Chunk
+		{
+			uint32_t submission;
+			uint32_t begin;
+			uint32_t end;
+		};
+
+		auto max_threads = GetMaxRecordingThreads();
+
+		std::vector<Chunk> chunks;
+		for (uint32_t i = 0; i < submissions_.size(); ++i)
+		{
+			const auto& submission = submissions_[i];
+
+			uint32_t num_passes = submission.end - submission.begin;
+			uint32_t num_chunks = std::min((num_passes + kMinPassesPerRecordingChunk - 1) / kMinPassesPerRecordingChunk, max_threads);
+			for (uint32_t chunk = 0; chunk < num_chunks; ++chunk)
+			{
+				chunks.push_back({ i, submission.begin + num_passes * chunk / num_chunks, submission.begin + num_passes * (chunk + 1) / num_chunks });
+			}
+		}
+
+		std::vector<rhi::CommandListHandle> command_lists(chunks.size());
+		std::atomic_uint32_t next_chunk = 0;
+
+		auto record_chunks = [&]()
+		{
+			std::vector<rhi::ResourceBarrier> barriers;
+			for (uint32_t i = next_chunk++; i < chunks.size(); i = next_chunk++)
+			{
+				const auto& chunk = chunks[i];
+
+				if (device)
+				{
+					command_lists[i] = device->GetCommandList(submissions_[chunk.submission].queue);
+				}
+
+				for (uint32_t position = chunk.begin; position < chunk.end; ++position)
+				{
+					RecordPass(position, chunk.begin, chunk.end, device, command_lists[i], barriers);
+				}
+			}
+		};
+
+		auto num_threads = std::min(static_cast<uint32_t>(chunks.size()), max_threads);
+
+		std::vector<std::future<void>> futures;
+		futures.reserve(num_threads);
+		for (uint32_t thread = 1; thread < num_threads; ++thread)
+		{
+			futures.push_back(std::async(std::launch::async, record_chunks));
+		}
+
+		record_chunks();
+
+		for (auto& future : futures)
+		{
+			future.get();
+		}
+
+		submission_fence_values_.assign(submissions_.size(), 0);
+		if (device)
+		{
+			auto& fence_values = submission_fence_values_;
+			std::vector<rhi::CommandList*> submit_lists;
+			submit_lists.reserve(chunks.size());
+
+			size_t chunk = 0;
+			for (uint32_t i = 0; i < submissions_.size(); ++i)
+			{
+				const auto& submission = submissions_[i];
+				auto queue = device->GetCommandQueue(submission.queue);
+
+				for (uint32_t j = submission.wait_offset; j < submission.wait_offset + submission.num_waits; ++j)
+				{
+					auto wait = submission_waits_[j];
+					queue->Wait(device->GetCommandQueue(submissions_[wait].queue), fence_values[wait]);
+				}
+
+				submit_lists.clear();
+				for (; chunk < chunks.size() && chunks[chunk].submission == i; ++chunk)
+				{
+					submit_lists.push_back(command_lists[chunk].Get());
+				}
+
+				fence_values[i] = queue->ExecuteCommandLists(submit_lists.size(), submit_lists.data());
 			}
 		}
+
+		// the pool hands the last released object out first,
+		// so the same graph gets the same objects back next frame and keeps its descriptor tables
+		for (auto rid : release_rids_)
+		{
+			resources_[rid].Destroy(resource_pool_);
+		}
+
+		SwapHistories();
+
+		resource_pool_.Tick();
 	}
 
-	void FrameGraph::Execute(rhi::Device* device)
+	void FrameGraph::SetMaxRecordingThreads(uint32_t num_threads)
 	{
-		for (auto& pass_node : pass_nodes_)
+		max_recording_threads_ = num_threads;
+	}
+
+	uint64_t FrameGraph::GetFenceValue(uint32_t pass_id) const
+	{
+		if (pass_id >= pass_submissions_.size() || pass_submissions_[pass_id] >= submission_fence_values_.size())
 		{
-			if (pass_node.CanExecute())
+			return 0;
+		}
+
+		return submission_fence_values_[pass_submissions_[pass_id]];
+	}
+
+	void FrameGraph::SetMemoryBudget(uint64_t bytes, FrameGraphBudgetPolicy policy)
+	{
+		if (memory_budget_ != bytes || budget_policy_ != policy)
+		{
+			memory_budget_ = bytes;
+			budget_policy_ = policy;
+			InvalidateCompileCache();
+		}
+	}
+
+	std::string FrameGraph::GetMemoryReport() const
+	{
+		auto to_mib = [](uint64_t bytes) { return std::to_string((bytes + (1 << 20) - 1) >> 20) + " MiB"; };
+
+		std::string report = "transient memory peak " + to_mib(memory_estimate_.peak_bytes);
+		if (memory_budget_ > 0)
+		{
+			report += ", budget " + to_mib(memory_budget_);
+		}
+
+		if (memory_estimate_.num_serialized_passes > 0)
+		{
+			report += ", " + std::to_string(memory_estimate_.num_serialized_passes) + " passes serialized";
+		}
+
+		if (memory_estimate_.peak_position < execution_order_.size())
+		{
+			report += ", at pass ";
+			report += pass_nodes_[execution_order_[memory_estimate_.peak_position]].name;
+			report += " (position " + std::to_string(memory_estimate_.peak_position) + ")";
+		}
+		report += "\n";
+
+		// the first node of a resource carries its name
+		std::vector<std::string_view> names(resources_.size());
+		for (auto it = resource_nodes_.rbegin(); it != resource_nodes_.rend(); ++it)
+		{
+			names[it->rid] = it->name;
+		}
+
+		for (auto rid : memory_estimate_.peak_rids)
+		{
+			const auto& resource = resources_[rid];
+
+			report += "\t";
+			report += names[rid];
+			report += " " + std::to_string(resource.GetMemorySize()) + " bytes " + resource.ToString() + "\n";
+		}
+
+		return report;
+	}
+
+	uint64_t FrameGraph::GetProfilingTimestamp() const
+	{
+		if (!profiling_enabled_)
+		{
+			return 0;
+		}
+
+		auto now = std::chrono::steady_clock::now().time_since_epoch();
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+	}
+
+	uint32_t FrameGraph::GetMaxRecordingThreads() const
+	{
+		if (max_recording_threads_ == 0)
+		{
+			return std::max(std::thread::hardware_concurrency(), 1u);
+		}
+
+		return max_recording_threads_;
+	}
+
+	void FrameGraph::RecordPass(uint32_t position, uint32_t chunk_begin, uint32_t chunk_end, rhi::Device* device, rhi::CommandList* command_list, std::vector<rhi::ResourceBarrier>& barriers)
+	{
+		auto& pass_node = pass_nodes_[execution_order_[position]];
+
+		if (command_list)
+		{
+			bool split = command_list->SupportsSplitBarriers();
+
+			barriers.clear();
+			for (uint32_t i = barrier_offsets_[position]; i < barrier_offsets_[position + 1]; ++i)
 			{
-				continue;
+				const auto& planned = barriers_[i];
+
+				rhi::ResourceBarrier barrier;
+				barrier.state_before = planned.before;
+				barrier.state_after = planned.after;
+				barrier.subresource = planned.subresource;
+				if (split && planned.split_begin != ~0u && planned.split_begin >= chunk_begin)
+				{
+					barrier.flags = rhi::ResourceBarrierFlags::kEndOnly;
+				}
+
+				if (resources_[planned.rid].FillBarrier(barrier))
+				{
+					barriers.push_back(barrier);
+				}
 			}
 
-			for (auto handle : pass_node.creates)
+			// transitions ending later in this list overlap with the passes in between
+			if (split)
 			{
-				GetFrameGraphResource(handle).Create();
+				for (uint32_t i = split_begin_offsets_[position]; i < split_begin_offsets_[position + 1]; ++i)
+				{
+					const auto& begin = split_begins_[i];
+					if (begin.end >= chunk_end)
+					{
+						continue;
+					}
+
+					const auto& planned = barriers_[begin.barrier];
+
+					rhi::ResourceBarrier barrier;
+					barrier.state_before = planned.before;
+					barrier.state_after = planned.after;
+					barrier.subresource = planned.subresource;
+					barrier.flags = rhi::ResourceBarrierFlags::kBeginOnly;
+					if (resources_[planned.rid].FillBarrier(barrier))
+					{
+						barriers.push_back(barrier);
+					}
+				}
 			}
 
-			FrameGraphPassResources resource(*this, pass_node);
-			std::invoke(*pass_node.execute, resource, device, nullptr);
-			
-			for (auto& resource : resources_)
+			if (!barriers.empty())
+			{
+				command_list->ResourceBarriers(static_cast<uint32_t>(barriers.size()), barriers.data());
+			}
+
+			auto render_pass = pass_render_passes_[pass_node.id];
+			if (render_pass != kInvalidRenderPass && (position == chunk_begin || render_passes_[render_pass].begin == position))
+			{
+				command_list->SetRenderTarget(render_targets_[render_pass]);
+			}
+		}
+
+		auto execute_begin = GetProfilingTimestamp();
+
+		FrameGraphPassResources resource(*this, pass_node);
+		std::invoke(*pass_node.execute, resource, device, command_list);
+
+		pass_stats_[pass_node.id].execute_ns = GetProfilingTimestamp() - execute_begin;
+
+		if (command_list && post_barrier_offsets_[position] != post_barrier_offsets_[position + 1])
+		{
+			// objects the command list tracks find their states on their own
+			barriers.clear();
+			for (uint32_t i = post_barrier_offsets_[position]; i < post_barrier_offsets_[position + 1]; ++i)
 			{
-				if (resource.last == &pass_node && !resource.IsImported())
+				const auto& planned = post_barriers_[i];
+
+				rhi::ResourceBarrier barrier;
+				barrier.state_before = planned.before;
+				barrier.state_after = planned.after;
+				barrier.subresource = planned.subresource;
+				if (resources_[planned.rid].FillBarrier(barrier)
+					&& (barrier.texture ? barrier.texture->IsPermanentState() : barrier.buffer && barrier.buffer->IsPermanentState()))
 				{
-					resource.Destroy();
+					barriers.push_back(barrier);
 				}
 			}
+
+			if (!barriers.empty())
+			{
+				command_list->ResourceBarriers(static_cast<uint32_t>(barriers.size()), barriers.data());
+			}
 		}
 	}
 
-	PassNode& FrameGraph::CreatePassNode(std::string_view name, std::unique_ptr<FrameGraphPassConcept> pass)
+	PassNode& FrameGraph::CreatePassNode(std::string_view name, rhi::CommandListType queue, FrameGraphPassConcept* pass)
 	{
 		uint32_t id = pass_nodes_.size();
-		auto& result = pass_nodes_.emplace_back(name, id, std::move(pass));
+		auto& result = pass_nodes_.emplace_back(arena_.CopyString(name), id, queue, pass, arena_);
+		pass_stats_.emplace_back();
 		return result;
 	}
 
-	ResourceNode& FrameGraph::CreateResourceNode(std::string_view name, uint32_t rid,uint32_t version)
+	ResourceNode& FrameGraph::CreateResourceNode(std::string_view name, uint32_t rid,uint32_t version, const FrameGraphSubresourceRange& range)
 	{
 		uint32_t id = resource_nodes_.size();
-		return resource_nodes_.emplace_back(name, id, rid, version);
+		return resource_nodes_.emplace_back(name, id, rid, version, range);
+	}
+
+	void FrameGraph::ReadVersions(PassNode& pass_node, FrameGraphHandle handle, const FrameGraphSubresourceRange& range)
+	{
+		// walks back until a version covers the whole range, the first one covers every subresource,
+		// writers of the other mips and slices stay independent of the pass
+		for (; handle != ~0u; handle = resource_nodes_[handle].previous)
+		{
+			const auto& version_range = resource_nodes_[handle].range;
+			if (version_range.Overlaps(range))
+			{
+				pass_node.Read(handle, FrameGraphAccess::kNone, version_range.Intersect(range));
+			}
+
+			if (version_range.Contains(range))
+			{
+				break;
+			}
+		}
 	}
 
-	FrameGraphHandle FrameGraph::CreateNewVersionNode(FrameGraphHandle handle)
+	FrameGraphHandle FrameGraph::CreateNewVersionNode(FrameGraphHandle handle, const FrameGraphSubresourceRange& range)
 	{
 		auto& resource_node = resource_nodes_[handle];
-		auto& resource = GetFrameGraphResource(resource_node.rid);
-		return CreateResourceNode(resource_node.name, resource_node.rid, ++resource.version).id;
+		auto& resource = resources_[resource_node.rid];
+		auto& node = CreateResourceNode(resource_node.name, resource_node.rid, ++resource.version, range);
+		node.previous = handle;
+		return node.id;
 	}
 
 	FrameGraphResource& FrameGraph::GetFrameGraphResource(FrameGraphHandle handle)
@@ -176,10 +619,1619 @@ namespace light::fg
 		return resources_[node.rid];
 	}
 
-	FrameGraphPassResources::FrameGraphPassResources(FrameGraph& framegraph, PassNode& pass_node)
-		: framegraph_(framegraph)
-		, pass_node_(pass_node)
+	FrameGraphHistoryId FrameGraph::AddHistory(HistoryResource&& history)
+	{
+		for (uint32_t id = 0; id < histories_.size(); ++id)
+		{
+			if (!histories_[id].models[0])
+			{
+				histories_[id] = std::move(history);
+				return id;
+			}
+		}
+
+		histories_.push_back(std::move(history));
+		return static_cast<FrameGraphHistoryId>(histories_.size() - 1);
+	}
+
+	void FrameGraph::ReleaseHistory(FrameGraphHistoryId id)
+	{
+		auto& history = histories_[id];
+		CHECK(!history.frame, "history is used by the current graph");
+
+		// the pool hands out objects in the common state, the others are dropped with the history
+		for (uint32_t slot = 0; slot < history.models.size(); ++slot)
+		{
+			if (history.created[slot] && (!history.models[slot]->IsPooled() || history.states[slot] == rhi::ResourceStates::kCommon))
+			{
+				history.models[slot]->Destroy(resource_pool_);
+			}
+		}
+
+		history = HistoryResource();
+	}
+
+	FrameGraphHistory FrameGraph::UseHistory(FrameGraphHistoryId id)
+	{
+		auto& history = histories_[id];
+		CHECK(history.models[0], "history was released");
+
+		if (!history.frame)
+		{
+			// imported for the graph: no per frame create/destroy, no aliasing, writers are kept
+			auto add_slot = [&](uint32_t slot)
+			{
+				auto rid = static_cast<uint32_t>(resources_.size());
+				resources_.emplace_back(rid, history.models[slot].get(), 0, true);
+				history_uses_.push_back({ id, slot, rid });
+
+				return CreateResourceNode(arena_.CopyString(history.name), rid, 0).id;
+			};
+
+			FrameGraphHistory frame;
+			frame.current = add_slot(history.current);
+			frame.previous = add_slot(history.current ^ 1);
+			frame.previous_valid = history.previous_valid;
+
+			history.frame = frame;
+		}
+
+		return *history.frame;
+	}
+
+	void FrameGraph::RealizeHistories(rhi::Device* device)
 	{
+		// objects of another device are recreated, the pool already dropped its own
+		if (history_device_ != device)
+		{
+			for (auto& history : histories_)
+			{
+				history.created = { false, false };
+				history.states = { rhi::ResourceStates::kCommon, rhi::ResourceStates::kCommon };
+				history.previous_valid = false;
+			}
+
+			history_device_ = device;
+		}
+
+		for (auto& use : history_uses_)
+		{
+			auto& history = histories_[use.history];
+			if (!history.created[use.slot])
+			{
+				history.models[use.slot]->Create(resource_pool_);
+				history.created[use.slot] = true;
+			}
+		}
+	}
+
+	void FrameGraph::SwapHistories()
+	{
+		for (size_t i = 0; i < history_uses_.size(); ++i)
+		{
+			const auto& use = history_uses_[i];
+			auto& history = histories_[use.history];
+
+			history.states[use.slot] = history_final_states_[i];
+
+			// a write made a new version of current
+			if (use.slot == history.current)
+			{
+				history.previous_valid = resources_[use.rid].version > 0;
+			}
+		}
+
+		for (auto& history : histories_)
+		{
+			if (history.frame)
+			{
+				history.current ^= 1;
+				history.frame.reset();
+			}
+		}
+	}
+
+	size_t FrameGraph::ComputeStructureHash() const
+	{
+		auto HashRange = [](size_t& hash, const FrameGraphSubresourceRange& range)
+		{
+			rhi::HashCombine(hash, range.first_mip);
+			rhi::HashCombine(hash, range.num_mips);
+			rhi::HashCombine(hash, range.first_slice);
+			rhi::HashCombine(hash, range.num_slices);
+		};
+
+		size_t hash = 0;
+		rhi::HashCombine(hash, pass_nodes_.size());
+		rhi::HashCombine(hash, resource_nodes_.size());
+		rhi::HashCombine(hash, resources_.size());
+		rhi::HashCombine(hash, scheduling_enabled_);
+		rhi::HashCombine(hash, submission_batching_enabled_);
+
+		for (auto& pass_node : pass_nodes_)
+		{
+			rhi::HashCombine(hash, std::string_view(pass_node.name));
+			rhi::HashCombine(hash, static_cast<uint32_t>(pass_node.queue));
+			rhi::HashCombine(hash, pass_node.side_effect);
+			rhi::HashCombine(hash, pass_node.readback);
+
+			rhi::HashCombine(hash, pass_node.creates.size());
+			for (auto handle : pass_node.creates)
+			{
+				rhi::HashCombine(hash, handle);
+			}
+
+			rhi::HashCombine(hash, pass_node.reads.size());
+			for (size_t i = 0; i < pass_node.reads.size(); ++i)
+			{
+				rhi::HashCombine(hash, pass_node.reads[i]);
+				rhi::HashCombine(hash, static_cast<uint16_t>(pass_node.read_accesses[i]));
+				HashRange(hash, pass_node.read_ranges[i]);
+			}
+
+			rhi::HashCombine(hash, pass_node.writes.size());
+			for (size_t i = 0; i < pass_node.writes.size(); ++i)
+			{
+				rhi::HashCombine(hash, pass_node.writes[i]);
+				rhi::HashCombine(hash, static_cast<uint16_t>(pass_node.write_accesses[i]));
+			}
+		}
+
+		for (auto& resource_node : resource_nodes_)
+		{
+			rhi::HashCombine(hash, resource_node.rid);
+			HashRange(hash, resource_node.range);
+		}
+
+		// descs reach the plan through the memory sizes, the desc hash catches the rest
+		for (auto& resource : resources_)
+		{
+			rhi::HashCombine(hash, resource.IsImported());
+			rhi::HashCombine(hash, resource.GetMemorySize());
+			rhi::HashCombine(hash, resource.GetDescHash());
+		}
+
+		// histories start in the states the last frame left them in
+		for (auto& use : history_uses_)
+		{
+			rhi::HashCombine(hash, static_cast<uint32_t>(histories_[use.history].states[use.slot]));
+		}
+
+		return hash;
+	}
+
+	void FrameGraph::SaveCompiledGraph(size_t hash)
+	{
+		auto pass_id = [](const PassNode* pass_node)
+		{
+			return pass_node ? pass_node->id : ~0u;
+		};
+
+		compiled_graph_.valid = true;
+		compiled_graph_.hash = hash;
+
+		compiled_graph_.pass_ref_counts.resize(pass_nodes_.size());
+		for (auto& pass_node : pass_nodes_)
+		{
+			compiled_graph_.pass_ref_counts[pass_node.id] = pass_node.ref_count;
+		}
+
+		compiled_graph_.resource_producers.resize(resources_.size());
+		compiled_graph_.resource_lasts.resize(resources_.size());
+		for (auto& resource : resources_)
+		{
+			compiled_graph_.resource_producers[resource.id] = pass_id(resource.producer);
+			compiled_graph_.resource_lasts[resource.id] = pass_id(resource.last);
+		}
+	}
+
+	void FrameGraph::RestoreCompiledGraph()
+	{
+		auto pass_node = [this](uint32_t id)
+		{
+			return id != ~0u ? &pass_nodes_[id] : nullptr;
+		};
+
+		for (auto& node : pass_nodes_)
+		{
+			node.ref_count = compiled_graph_.pass_ref_counts[node.id];
+		}
+
+		for (auto& resource : resources_)
+		{
+			resource.producer = pass_node(compiled_graph_.resource_producers[resource.id]);
+			resource.last = pass_node(compiled_graph_.resource_lasts[resource.id]);
+		}
+	}
+
+	void FrameGraph::AssignResourceLifetimes()
+	{
+		for (auto id : execution_order_)
+		{
+			auto& pass_node = pass_nodes_[id];
+
+			for (auto handle : pass_node.creates)
+			{
+				GetFrameGraphResource(handle).producer = &pass_node;
+			}
+
+			for (auto handle : pass_node.reads)
+			{
+				GetFrameGraphResource(handle).last = &pass_node;
+			}
+
+			for (auto handle : pass_node.writes)
+			{
+				GetFrameGraphResource(handle).last = &pass_node;
+			}
+		}
+	}
+
+	void FrameGraph::PlanResourceLifetimes()
+	{
+		create_offsets_.assign(pass_nodes_.size() + 1, 0);
+
+		// counting sort of the transient resources by their first pass
+		for (auto& resource : resources_)
+		{
+			if (resource.IsImported() || !resource.producer)
+			{
+				continue;
+			}
+
+			++create_offsets_[resource.producer->id + 1];
+		}
+
+		for (size_t i = 1; i < create_offsets_.size(); ++i)
+		{
+			create_offsets_[i] += create_offsets_[i - 1];
+		}
+
+		create_rids_.resize(create_offsets_.back());
+
+		std::vector<uint32_t> create_cursors(create_offsets_.begin(), create_offsets_.end() - 1);
+		for (auto& resource : resources_)
+		{
+			if (resource.IsImported() || !resource.producer)
+			{
+				continue;
+			}
+
+			create_rids_[create_cursors[resource.producer->id]++] = resource.id;
+		}
+
+		PlanObjectReuse();
+	}
+
+	void FrameGraph::PlanObjectReuse()
+	{
+		std::vector<uint32_t> positions(pass_nodes_.size(), ~0u);
+		for (uint32_t position = 0; position < execution_order_.size(); ++position)
+		{
+			positions[execution_order_[position]] = position;
+		}
+
+		// the queue every resource is used on, the queue orders the last use of an object before the first one of the next resource
+		constexpr uint32_t kNoQueue = ~0u;
+		constexpr uint32_t kMixedQueues = ~0u - 1;
+		std::vector<uint32_t> queues(resources_.size(), kNoQueue);
+		for (auto id : execution_order_)
+		{
+			auto& pass_node = pass_nodes_[id];
+			auto queue = static_cast<uint32_t>(pass_node.queue);
+			for (auto* handles : { &pass_node.creates, &pass_node.reads, &pass_node.writes })
+			{
+				for (auto handle : *handles)
+				{
+					auto& resource_queue = queues[resource_nodes_[handle].rid];
+					resource_queue = resource_queue == kNoQueue || resource_queue == queue ? queue : kMixedQueues;
+				}
+			}
+		}
+
+		// objects whose last user ran, by desc and queue, a min heap of (last position, rid).
+		// descs sharing a hash get a heap each, the object of another desc has other subresources
+		using IdleObject = std::pair<uint32_t, uint32_t>;
+		struct IdleObjects
+		{
+			uint32_t rid;	// any holder, every object of the heap serves its desc
+			std::vector<IdleObject> heap;
+		};
+		std::unordered_map<size_t, std::vector<IdleObjects>> idle_objects;
+
+		// the last resource of every object in the order the objects were first realized
+		std::vector<uint32_t> object_of(resources_.size(), ~0u);
+		std::vector<uint32_t> object_holders;
+
+		create_predecessors_.assign(create_rids_.size(), ~0u);
+		for (auto id : execution_order_)
+		{
+			for (uint32_t i = create_offsets_[id]; i < create_offsets_[id + 1]; ++i)
+			{
+				auto& resource = resources_[create_rids_[i]];
+				auto first = positions[resource.producer->id];
+				auto last = positions[(resource.last ? resource.last : resource.producer)->id];
+
+				if (!resource.IsPooled() || queues[resource.id] == kMixedQueues)
+				{
+					object_of[resource.id] = static_cast<uint32_t>(object_holders.size());
+					object_holders.push_back(resource.id);
+					continue;
+				}
+
+				auto key = resource.GetDescHash();
+				rhi::HashCombine(key, queues[resource.id]);
+
+				auto& buckets = idle_objects[key];
+				auto bucket = std::find_if(buckets.begin(), buckets.end(), [this, &resource](const IdleObjects& objects)
+					{
+						return resources_[objects.rid].IsCompatible(resource);
+					});
+				if (bucket == buckets.end())
+				{
+					buckets.push_back({ resource.id, {} });
+					bucket = std::prev(buckets.end());
+				}
+
+				auto& idle = bucket->heap;
+				if (!idle.empty() && idle.front().first < first)
+				{
+					auto predecessor = idle.front().second;
+					std::pop_heap(idle.begin(), idle.end(), std::greater<IdleObject>());
+					idle.pop_back();
+
+					create_predecessors_[i] = predecessor;
+					object_of[resource.id] = object_of[predecessor];
+					object_holders[object_of[resource.id]] = resource.id;
+				}
+				else
+				{
+					object_of[resource.id] = static_cast<uint32_t>(object_holders.size());
+					object_holders.push_back(resource.id);
+				}
+
+				idle.emplace_back(last, resource.id);
+				std::push_heap(idle.begin(), idle.end(), std::greater<IdleObject>());
+			}
+		}
+
+		// reverse first realize order, the objects come back in the order the next frame asks for them
+		release_rids_.assign(object_holders.rbegin(), object_holders.rend());
+	}
+
+	void FrameGraph::EstimateMemory()
+	{
+		memory_estimate_.peak_bytes = 0;
+		memory_estimate_.peak_position = 0;
+		memory_estimate_.peak_rids.clear();
+
+		// Execute realizes every object up front and releases them after the submit, a resource taking over
+		// the object of an earlier one adds nothing, so the bytes only grow with each new object
+		for (uint32_t position = 0; position < execution_order_.size(); ++position)
+		{
+			auto id = execution_order_[position];
+			for (uint32_t i = create_offsets_[id]; i < create_offsets_[id + 1]; ++i)
+			{
+				auto& resource = resources_[create_rids_[i]];
+				if (create_predecessors_[i] != ~0u || resource.GetMemorySize() == 0)
+				{
+					continue;
+				}
+
+				memory_estimate_.peak_bytes += resource.GetMemorySize();
+				memory_estimate_.peak_position = position;
+				memory_estimate_.peak_rids.push_back(resource.id);
+			}
+		}
+
+		std::stable_sort(memory_estimate_.peak_rids.begin(), memory_estimate_.peak_rids.end(), [&](uint32_t a, uint32_t b)
+			{
+				return resources_[a].GetMemorySize() > resources_[b].GetMemorySize();
+			});
+	}
+
+	void FrameGraph::CollectPassUsages(const PassNode& pass_node, std::vector<PassUsage>& usages) const
+	{
+		// a shader resource read on the compute queue is a non pixel shader resource only
+		auto queue_states = GetQueueResourceStates(pass_node.queue);
+
+		usages.clear();
+		for (size_t i = 0; i < pass_node.writes.size(); ++i)
+		{
+			if (pass_node.write_accesses[i] != 0)
+			{
+				auto& resource_node = resource_nodes_[pass_node.writes[i]];
+				auto range = resource_node.range.Resolve(resources_[resource_node.rid].GetSubresources());
+				usages.push_back({ resource_node.rid, range, ConvertAccessToResourceStates(pass_node.write_accesses[i]) & queue_states, true });
+			}
+		}
+
+		for (size_t i = 0; i < pass_node.reads.size(); ++i)
+		{
+			if (pass_node.read_accesses[i] == 0)
+			{
+				continue;
+			}
+
+			auto rid = resource_nodes_[pass_node.reads[i]].rid;
+			auto range = pass_node.read_ranges[i].Resolve(resources_[rid].GetSubresources());
+			auto it = std::find_if(usages.begin(), usages.end(), [rid, &range](const PassUsage& usage) { return usage.rid == rid && usage.range == range; });
+			if (it == usages.end())
+			{
+				usages.push_back({ rid, range, ConvertAccessToResourceStates(pass_node.read_accesses[i]) & queue_states, false });
+			}
+			else if (!it->write)
+			{
+				it->state = it->state | (ConvertAccessToResourceStates(pass_node.read_accesses[i]) & queue_states);
+			}
+		}
+
+#ifdef _DEBUG
+		// the objects of pooled resources are in permanent state, the command lists drop their transitions
+		// so a pass that declares one without an access would leave it in the wrong state
+		auto is_permanent = [this](uint32_t rid) { return !resources_[rid].IsImported() && resources_[rid].IsPooled(); };
+
+		for (size_t i = 0; i < pass_node.writes.size(); ++i)
+		{
+			CHECK(pass_node.write_accesses[i] != 0 || !is_permanent(resource_nodes_[pass_node.writes[i]].rid), "write of a pooled resource without an access");
+		}
+
+		// reads without an access only order the pass after earlier versions, the pass names an access of the resource too
+		for (size_t i = 0; i < pass_node.reads.size(); ++i)
+		{
+			auto rid = resource_nodes_[pass_node.reads[i]].rid;
+			if (pass_node.read_accesses[i] == 0 && is_permanent(rid))
+			{
+				bool used = std::any_of(usages.begin(), usages.end(), [rid](const PassUsage& usage) { return usage.rid == rid; });
+				CHECK(used, "read of a pooled resource without an access");
+			}
+		}
+#endif
+	}
+
+	void FrameGraph::ResetBarrierTracker(BarrierTracker& tracker) const
+	{
+		tracker.subresource_offsets.resize(resources_.size());
+		tracker.subresources.resize(resources_.size());
+
+		uint32_t num_subresources = 0;
+		for (size_t i = 0; i < resources_.size(); ++i)
+		{
+			tracker.subresource_offsets[i] = num_subresources;
+			tracker.subresources[i] = resources_[i].GetSubresources();
+			num_subresources += tracker.subresources[i].num_mips * tracker.subresources[i].num_slices;
+		}
+
+		tracker.states.assign(num_subresources, rhi::ResourceStates::kCommon);
+		tracker.unordered_access_written.assign(num_subresources, false);
+		tracker.pass_states.assign(num_subresources, rhi::ResourceStates::kCommon);
+		tracker.pass_writes.assign(num_subresources, false);
+		tracker.pass_stamps.assign(num_subresources, 0);
+		tracker.stamp = 0;
+
+		for (auto& use : history_uses_)
+		{
+			auto offset = tracker.subresource_offsets[use.rid];
+			auto count = tracker.subresources[use.rid].num_mips * tracker.subresources[use.rid].num_slices;
+			std::fill_n(tracker.states.begin() + offset, count, histories_[use.history].states[use.slot]);
+		}
+	}
+
+	uint32_t FrameGraph::CountBarriers(const BarrierTracker& tracker, const PassUsage& usage)
+	{
+		uint32_t num_barriers = 0;
+		ForEachSubresource(tracker, usage, [&](uint32_t index, uint32_t)
+			{
+				if (tracker.states[index] != usage.state
+					|| (usage.state == rhi::ResourceStates::kUnorderedAccess && tracker.unordered_access_written[index]))
+				{
+					++num_barriers;
+				}
+			});
+		return num_barriers;
+	}
+
+	void FrameGraph::TrackPassUsages(const std::vector<PassUsage>& usages, BarrierTracker& tracker, std::vector<FrameGraphBarrier>& barriers)
+	{
+		++tracker.stamp;
+
+		// a write of a subresource wins over the reads of it, reads of the same subresource combine their states
+		for (auto& usage : usages)
+		{
+			ForEachSubresource(tracker, usage, [&](uint32_t index, uint32_t)
+				{
+					if (tracker.pass_stamps[index] != tracker.stamp)
+					{
+						tracker.pass_stamps[index] = tracker.stamp;
+						tracker.pass_states[index] = usage.state;
+						tracker.pass_writes[index] = usage.write;
+					}
+					else if (usage.write || !tracker.pass_writes[index])
+					{
+						tracker.pass_states[index] = tracker.pass_states[index] | usage.state;
+						tracker.pass_writes[index] = tracker.pass_writes[index] || usage.write;
+					}
+				});
+		}
+
+		for (auto& usage : usages)
+		{
+			auto offset = tracker.subresource_offsets[usage.rid];
+			auto& subresources = tracker.subresources[usage.rid];
+
+			// subresources an earlier usage of the same pass overlapped are already tracked,
+			// the whole resource in one state on both sides collapses to a single barrier
+			bool uniform = usage.range.IsWhole(subresources);
+			ForEachSubresource(tracker, usage, [&](uint32_t index, uint32_t)
+				{
+					uniform = uniform
+						&& tracker.pass_stamps[index] == tracker.stamp
+						&& tracker.states[index] == tracker.states[offset]
+						&& tracker.pass_states[index] == tracker.pass_states[offset]
+						&& tracker.unordered_access_written[index] == tracker.unordered_access_written[offset];
+				});
+
+			if (uniform)
+			{
+				auto before = tracker.states[offset];
+				auto after = tracker.pass_states[offset];
+				// same state on both sides is the uav barrier between two unordered access passes
+				if (before != after || (after == rhi::ResourceStates::kUnorderedAccess && tracker.unordered_access_written[offset]))
+				{
+					barriers.push_back({ usage.rid, before, after });
+				}
+			}
+
+			bool unordered_access_barrier = false;
+			ForEachSubresource(tracker, usage, [&](uint32_t index, uint32_t subresource)
+				{
+					if (tracker.pass_stamps[index] != tracker.stamp)
+					{
+						return;
+					}
+
+					auto before = tracker.states[index];
+					auto after = tracker.pass_states[index];
+					if (!uniform)
+					{
+						if (before != after)
+						{
+							barriers.push_back({ usage.rid, before, after, subresource });
+						}
+						else if (after == rhi::ResourceStates::kUnorderedAccess && tracker.unordered_access_written[index] && !unordered_access_barrier)
+						{
+							// uav barriers can't name a subresource, one covers the whole resource
+							barriers.push_back({ usage.rid, before, after });
+							unordered_access_barrier = true;
+						}
+					}
+
+					tracker.states[index] = after;
+					tracker.unordered_access_written[index] = tracker.pass_writes[index] && after == rhi::ResourceStates::kUnorderedAccess;
+					tracker.pass_stamps[index] = 0;
+				});
+		}
+	}
+
+	void FrameGraph::BuildHazardGraph(HazardGraph& graph) const
+	{
+		constexpr uint32_t kNone = ~0u;
+
+		std::vector<std::pair<uint32_t, uint32_t>> edges;
+		std::vector<uint32_t> last_write(resources_.size(), kNone);
+		std::vector<std::vector<uint32_t>> last_reads(resources_.size());
+		uint32_t last_side_effect = kNone;
+
+		for (auto id : execution_order_)
+		{
+			auto& pass_node = pass_nodes_[id];
+
+			for (auto handle : pass_node.reads)
+			{
+				auto rid = resource_nodes_[handle].rid;
+				if (last_write[rid] != kNone)
+				{
+					edges.push_back({ last_write[rid], id });
+				}
+				last_reads[rid].push_back(id);
+			}
+
+			for (auto handle : pass_node.writes)
+			{
+				auto rid = resource_nodes_[handle].rid;
+				if (last_write[rid] != kNone)
+				{
+					edges.push_back({ last_write[rid], id });
+				}
+
+				for (auto reader : last_reads[rid])
+				{
+					if (reader != id)
+					{
+						edges.push_back({ reader, id });
+					}
+				}
+
+				last_write[rid] = id;
+				last_reads[rid].clear();
+			}
+
+			if (pass_node.HasSideEffect())
+			{
+				if (last_side_effect != kNone)
+				{
+					edges.push_back({ last_side_effect, id });
+				}
+				last_side_effect = id;
+			}
+		}
+
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+		auto& successor_offsets = graph.successor_offsets;
+		auto& successors = graph.successors;
+		auto& num_predecessors = graph.num_predecessors;
+
+		successor_offsets.assign(pass_nodes_.size() + 1, 0);
+		successors.resize(edges.size());
+		num_predecessors.assign(pass_nodes_.size(), 0);
+		for (auto& edge : edges)
+		{
+			++successor_offsets[edge.first + 1];
+			++num_predecessors[edge.second];
+		}
+
+		for (size_t i = 1; i < successor_offsets.size(); ++i)
+		{
+			successor_offsets[i] += successor_offsets[i - 1];
+		}
+
+		for (size_t i = 0; i < edges.size(); ++i)
+		{
+			successors[i] = edges[i].second;
+		}
+	}
+
+	void FrameGraph::ScheduleExecutionOrder()
+	{
+		constexpr uint32_t kNone = ~0u;
+
+		schedule_stats_.declaration_order = execution_order_;
+
+		// usages of every executed pass, usages_[usage_offsets[id], usage_offsets[id + 1])
+		std::vector<PassUsage> usages;
+		std::vector<PassUsage> pass_usages;
+		std::vector<uint32_t> usage_offsets(pass_nodes_.size() + 1, 0);
+		for (auto& pass_node : pass_nodes_)
+		{
+			usage_offsets[pass_node.id] = static_cast<uint32_t>(usages.size());
+			if (pass_node.CanExecute())
+			{
+				CollectPassUsages(pass_node, pass_usages);
+				usages.insert(usages.end(), pass_usages.begin(), pass_usages.end());
+			}
+		}
+		usage_offsets[pass_nodes_.size()] = static_cast<uint32_t>(usages.size());
+
+		auto track = [&](uint32_t id, BarrierTracker& tracker, std::vector<FrameGraphBarrier>& barriers)
+		{
+			pass_usages.assign(usages.begin() + usage_offsets[id], usages.begin() + usage_offsets[id + 1]);
+			TrackPassUsages(pass_usages, tracker, barriers);
+		};
+
+		schedule_stats_.num_declaration_barriers = CountOrderBarriers();
+
+		HazardGraph hazards;
+		BuildHazardGraph(hazards);
+
+		auto& successor_offsets = hazards.successor_offsets;
+		auto& successors = hazards.successors;
+		auto& num_predecessors = hazards.num_predecessors;
+
+		std::vector<uint32_t> ready;
+		for (auto id : execution_order_)
+		{
+			if (num_predecessors[id] == 0)
+			{
+				ready.push_back(id);
+			}
+		}
+
+		// consumers of the last scheduled pass, picked last so producer and consumer move apart
+		std::vector<bool> consumes_previous(pass_nodes_.size(), false);
+
+		BarrierTracker tracker;
+		std::vector<FrameGraphBarrier> barriers;
+
+		ResetBarrierTracker(tracker);
+		execution_order_.clear();
+
+		uint32_t previous = kNone;
+		while (!ready.empty())
+		{
+			// fewest transitions first, then not consuming the previous pass, then declaration order
+			size_t best = 0;
+			uint32_t best_barriers = kNone;
+			for (size_t i = 0; i < ready.size(); ++i)
+			{
+				auto id = ready[i];
+
+				uint32_t num_barriers = 0;
+				for (uint32_t j = usage_offsets[id]; j < usage_offsets[id + 1]; ++j)
+				{
+					num_barriers += CountBarriers(tracker, usages[j]);
+				}
+
+				auto better = [&]()
+				{
+					if (num_barriers != best_barriers)
+					{
+						return num_barriers < best_barriers;
+					}
+
+					if (consumes_previous[id] != consumes_previous[ready[best]])
+					{
+						return !consumes_previous[id];
+					}
+
+					return id < ready[best];
+				};
+
+				if (best_barriers == kNone || better())
+				{
+					best = i;
+					best_barriers = num_barriers;
+				}
+			}
+
+			auto id = ready[best];
+			ready[best] = ready.back();
+			ready.pop_back();
+
+			execution_order_.push_back(id);
+			track(id, tracker, barriers);
+
+			if (previous != kNone)
+			{
+				for (uint32_t i = successor_offsets[previous]; i < successor_offsets[previous + 1]; ++i)
+				{
+					consumes_previous[successors[i]] = false;
+				}
+			}
+			previous = id;
+
+			for (uint32_t i = successor_offsets[id]; i < successor_offsets[id + 1]; ++i)
+			{
+				auto successor = successors[i];
+				consumes_previous[successor] = true;
+				if (--num_predecessors[successor] == 0)
+				{
+					ready.push_back(successor);
+				}
+			}
+		}
+
+		schedule_stats_.num_scheduled_barriers = static_cast<uint32_t>(barriers.size());
+	}
+
+	uint32_t FrameGraph::CountOrderBarriers() const
+	{
+		BarrierTracker tracker;
+		ResetBarrierTracker(tracker);
+
+		std::vector<PassUsage> usages;
+		std::vector<FrameGraphBarrier> barriers;
+		for (auto id : execution_order_)
+		{
+			CollectPassUsages(pass_nodes_[id], usages);
+			TrackPassUsages(usages, tracker, barriers);
+		}
+
+		return static_cast<uint32_t>(barriers.size());
+	}
+
+	void FrameGraph::ScheduleForMemory(uint64_t live_bytes_limit)
+	{
+		HazardGraph hazards;
+		BuildHazardGraph(hazards);
+
+		// size of every transient resource and the executed passes still using it
+		std::vector<uint64_t> sizes(resources_.size(), 0);
+		std::vector<uint32_t> num_users(resources_.size(), 0);
+		std::vector<bool> allocated(resources_.size(), false);
+		for (auto& resource : resources_)
+		{
+			if (!resource.IsImported() && resource.producer)
+			{
+				sizes[resource.id] = resource.GetMemorySize();
+			}
+		}
+
+		// calls function once per transient resource of the pass
+		std::vector<uint32_t> stamps(resources_.size(), 0);
+		uint32_t stamp = 0;
+		auto for_each_resource = [&](uint32_t id, auto&& function)
+		{
+			++stamp;
+
+			auto& pass_node = pass_nodes_[id];
+			for (auto* handles : { &pass_node.reads, &pass_node.writes })
+			{
+				for (auto handle : *handles)
+				{
+					auto rid = resource_nodes_[handle].rid;
+					if (sizes[rid] > 0 && stamps[rid] != stamp)
+					{
+						stamps[rid] = stamp;
+						function(rid);
+					}
+				}
+			}
+		};
+
+		std::vector<uint32_t> positions(pass_nodes_.size(), ~0u);
+		for (uint32_t position = 0; position < execution_order_.size(); ++position)
+		{
+			positions[execution_order_[position]] = position;
+			for_each_resource(execution_order_[position], [&](uint32_t rid) { ++num_users[rid]; });
+		}
+
+		std::vector<uint32_t> ready;
+		for (auto id : execution_order_)
+		{
+			if (hazards.num_predecessors[id] == 0)
+			{
+				ready.push_back(id);
+			}
+		}
+
+		// bytes of the resources the pass allocates, and of those it allocates minus those it frees
+		auto pass_bytes = [&](uint32_t id, int64_t& allocated_bytes, int64_t& net_bytes)
+		{
+			allocated_bytes = 0;
+			net_bytes = 0;
+			for_each_resource(id, [&](uint32_t rid)
+				{
+					if (!allocated[rid])
+					{
+						allocated_bytes += static_cast<int64_t>(sizes[rid]);
+						net_bytes += static_cast<int64_t>(sizes[rid]);
+					}
+
+					if (num_users[rid] == 1)
+					{
+						net_bytes -= static_cast<int64_t>(sizes[rid]);
+					}
+				});
+		};
+
+		memory_estimate_.num_serialized_passes = 0;
+
+		int64_t live_bytes = 0;
+		execution_order_.clear();
+		while (!ready.empty())
+		{
+			// the earliest ready pass of the incoming order, so the scheduled and batched order holds where the budget does
+			size_t best = 0;
+			for (size_t i = 1; i < ready.size(); ++i)
+			{
+				if (positions[ready[i]] < positions[ready[best]])
+				{
+					best = i;
+				}
+			}
+
+			int64_t allocated_bytes = 0;
+			int64_t net_bytes = 0;
+			pass_bytes(ready[best], allocated_bytes, net_bytes);
+
+			// it would overlap more lifetimes than the limit holds, the pass allocating the fewest minus
+			// freeing the most bytes goes first, then the earliest one
+			if (live_bytes + allocated_bytes > static_cast<int64_t>(live_bytes_limit))
+			{
+				auto earliest = best;
+				int64_t best_bytes = net_bytes;
+				for (size_t i = 0; i < ready.size(); ++i)
+				{
+					pass_bytes(ready[i], allocated_bytes, net_bytes);
+					if (net_bytes < best_bytes || (net_bytes == best_bytes && positions[ready[i]] < positions[ready[best]]))
+					{
+						best = i;
+						best_bytes = net_bytes;
+					}
+				}
+
+				if (best != earliest)
+				{
+					++memory_estimate_.num_serialized_passes;
+				}
+			}
+
+			auto id = ready[best];
+			ready[best] = ready.back();
+			ready.pop_back();
+
+			execution_order_.push_back(id);
+
+			pass_bytes(id, allocated_bytes, net_bytes);
+			live_bytes += net_bytes;
+
+			for_each_resource(id, [&](uint32_t rid)
+				{
+					allocated[rid] = true;
+					--num_users[rid];
+				});
+
+			for (uint32_t i = hazards.successor_offsets[id]; i < hazards.successor_offsets[id + 1]; ++i)
+			{
+				auto successor = hazards.successors[i];
+				if (--hazards.num_predecessors[successor] == 0)
+				{
+					ready.push_back(successor);
+				}
+			}
+		}
+	}
+
+	void FrameGraph::BatchSubmissions()
+	{
+		bool single_queue = std::all_of(execution_order_.begin(), execution_order_.end(), [&](uint32_t id)
+			{
+				return pass_nodes_[id].queue == pass_nodes_[execution_order_.front()].queue;
+			});
+
+		if (single_queue)
+		{
+			return;
+		}
+
+		constexpr uint32_t kNumQueues = static_cast<uint32_t>(rhi::CommandListType::kCopy) + 1;
+
+		HazardGraph hazards;
+		BuildHazardGraph(hazards);
+
+		std::vector<uint32_t> positions(pass_nodes_.size(), ~0u);
+		for (uint32_t position = 0; position < execution_order_.size(); ++position)
+		{
+			positions[execution_order_[position]] = position;
+		}
+
+		// the passes of every queue keep their incoming order, batching only picks the queue running next
+		std::array<std::vector<uint32_t>, kNumQueues> queue_orders;
+		std::array<size_t, kNumQueues> cursors{};
+		for (auto id : execution_order_)
+		{
+			queue_orders[static_cast<uint32_t>(pass_nodes_[id].queue)].push_back(id);
+		}
+
+		auto next_ready = [&](uint32_t queue)
+		{
+			return cursors[queue] < queue_orders[queue].size() && hazards.num_predecessors[queue_orders[queue][cursors[queue]]] == 0;
+		};
+
+		auto queue = static_cast<uint32_t>(pass_nodes_[execution_order_.front()].queue);
+		auto num_passes = execution_order_.size();
+
+		execution_order_.clear();
+		while (execution_order_.size() < num_passes)
+		{
+			// the next pass of the current queue, the earliest next pass of all queues once it waits on another one.
+			// that one is always ready, the incoming order is topological
+			if (!next_ready(queue))
+			{
+				uint32_t best = kNumQueues;
+				for (uint32_t other = 0; other < kNumQueues; ++other)
+				{
+					if (cursors[other] < queue_orders[other].size() &&
+						(best == kNumQueues || positions[queue_orders[other][cursors[other]]] < positions[queue_orders[best][cursors[best]]]))
+					{
+						best = other;
+					}
+				}
+				queue = best;
+			}
+
+			auto id = queue_orders[queue][cursors[queue]++];
+			execution_order_.push_back(id);
+
+			for (uint32_t i = hazards.successor_offsets[id]; i < hazards.successor_offsets[id + 1]; ++i)
+			{
+				--hazards.num_predecessors[hazards.successors[i]];
+			}
+		}
+	}
+
+	void FrameGraph::PlanBarriers()
+	{
+		barriers_.clear();
+		barrier_offsets_.resize(execution_order_.size() + 1);
+
+		BarrierTracker tracker;
+		ResetBarrierTracker(tracker);
+
+		// transitions recorded right after the pass at a position
+		std::vector<std::pair<uint32_t, FrameGraphBarrier>> post_barriers;
+
+		// last position using every resource
+		std::vector<uint32_t> last_use(resources_.size(), ~0u);
+
+		std::vector<PassUsage> usages;
+		for (uint32_t position = 0; position < execution_order_.size(); ++position)
+		{
+			barrier_offsets_[position] = static_cast<uint32_t>(barriers_.size());
+
+			// a resource taking over a pooled object starts in the states the previous holder left it in
+			auto id = execution_order_[position];
+			for (uint32_t i = create_offsets_[id]; i < create_offsets_[id + 1]; ++i)
+			{
+				if (create_predecessors_[i] != ~0u)
+				{
+					auto from = tracker.subresource_offsets[create_predecessors_[i]];
+					auto to = tracker.subresource_offsets[create_rids_[i]];
+					auto count = tracker.subresources[create_rids_[i]].num_mips * tracker.subresources[create_rids_[i]].num_slices;
+					std::copy_n(tracker.states.begin() + from, count, tracker.states.begin() + to);
+					std::copy_n(tracker.unordered_access_written.begin() + from, count, tracker.unordered_access_written.begin() + to);
+				}
+			}
+
+			auto& pass_node = pass_nodes_[id];
+			CollectPassUsages(pass_node, usages);
+			TrackPassUsages(usages, tracker, barriers_);
+
+			// the lists of the compute and copy queues can't transition out of a graphics state,
+			// the last user does it after its pass when that was on the direct queue, PlanSubmissions orders it before this pass
+			if (pass_node.queue != rhi::CommandListType::kDirect)
+			{
+				auto queue_states = GetQueueResourceStates(pass_node.queue);
+
+				auto kept = barrier_offsets_[position];
+				for (uint32_t i = kept; i < barriers_.size(); ++i)
+				{
+					auto& barrier = barriers_[i];
+					auto last = last_use[barrier.rid];
+					if ((barrier.before & ~queue_states) != 0 && last != ~0u
+						&& pass_nodes_[execution_order_[last]].queue == rhi::CommandListType::kDirect)
+					{
+						post_barriers.emplace_back(last, barrier);
+					}
+					else
+					{
+						barriers_[kept++] = barrier;
+					}
+				}
+				barriers_.resize(kept);
+			}
+
+			for (auto& usage : usages)
+			{
+				last_use[usage.rid] = position;
+			}
+		}
+
+		barrier_offsets_[execution_order_.size()] = static_cast<uint32_t>(barriers_.size());
+
+		PlanReleaseBarriers(tracker, post_barriers);
+
+		// counting sort of the post pass transitions by their position
+		post_barrier_offsets_.assign(execution_order_.size() + 1, 0);
+		for (auto& [position, barrier] : post_barriers)
+		{
+			++post_barrier_offsets_[position + 1];
+		}
+
+		for (size_t i = 1; i < post_barrier_offsets_.size(); ++i)
+		{
+			post_barrier_offsets_[i] += post_barrier_offsets_[i - 1];
+		}
+
+		post_barriers_.resize(post_barrier_offsets_.back());
+
+		std::vector<uint32_t> cursors(post_barrier_offsets_.begin(), post_barrier_offsets_.end() - 1);
+		for (auto& [position, barrier] : post_barriers)
+		{
+			post_barriers_[cursors[position]++] = barrier;
+		}
+
+		history_final_states_.clear();
+		for (auto& use : history_uses_)
+		{
+			auto offset = tracker.subresource_offsets[use.rid];
+			auto count = tracker.subresources[use.rid].num_mips * tracker.subresources[use.rid].num_slices;
+			[[maybe_unused]] bool uniform = std::all_of(tracker.states.begin() + offset, tracker.states.begin() + offset + count,
+				[&](rhi::ResourceStates state) { return state == tracker.states[offset]; });
+			CHECK(uniform, "history resources have to end the frame in one state");
+
+			history_final_states_.push_back(tracker.states[offset]);
+		}
+	}
+
+	void FrameGraph::PlanReleaseBarriers(const BarrierTracker& tracker, std::vector<std::pair<uint32_t, FrameGraphBarrier>>& post_barriers) const
+	{
+		std::vector<uint32_t> positions(pass_nodes_.size(), ~0u);
+		for (uint32_t position = 0; position < execution_order_.size(); ++position)
+		{
+			positions[execution_order_[position]] = position;
+		}
+
+		// nothing uses the last holder of an object after its last pass, the tracker still has the states it left
+		for (auto rid : release_rids_)
+		{
+			auto& resource = resources_[rid];
+			auto position = positions[(resource.last ? resource.last : resource.producer)->id];
+
+			auto offset = tracker.subresource_offsets[rid];
+			auto count = tracker.subresources[rid].num_mips * tracker.subresources[rid].num_slices;
+			bool uniform = std::all_of(tracker.states.begin() + offset, tracker.states.begin() + offset + count,
+				[&](rhi::ResourceStates state) { return state == tracker.states[offset]; });
+
+			if (uniform)
+			{
+				if (tracker.states[offset] != rhi::ResourceStates::kCommon)
+				{
+					post_barriers.emplace_back(position, FrameGraphBarrier{ rid, tracker.states[offset], rhi::ResourceStates::kCommon });
+				}
+				continue;
+			}
+
+			for (uint32_t subresource = 0; subresource < count; ++subresource)
+			{
+				if (tracker.states[offset + subresource] != rhi::ResourceStates::kCommon)
+				{
+					post_barriers.emplace_back(position, FrameGraphBarrier{ rid, tracker.states[offset + subresource], rhi::ResourceStates::kCommon, subresource });
+				}
+			}
+		}
+	}
+
+	void FrameGraph::PlanSplitBarriers()
+	{
+		constexpr uint32_t kNone = ~0u;
+
+		split_begins_.clear();
+		split_begin_offsets_.assign(execution_order_.size() + 1, 0);
+
+		// last position using every resource, a transition may begin right after it
+		std::vector<uint32_t> last_use(resources_.size(), kNone);
+		auto for_each_split = [&](auto&& function)
+		{
+			std::fill(last_use.begin(), last_use.end(), kNone);
+			for (uint32_t position = 0; position < execution_order_.size(); ++position)
+			{
+				for (uint32_t i = barrier_offsets_[position]; i < barrier_offsets_[position + 1]; ++i)
+				{
+					auto& barrier = barriers_[i];
+					auto last = last_use[barrier.rid];
+					if (barrier.before != barrier.after && last != kNone && last + 1 < position)
+					{
+						function(barrier, i, last + 1, position);
+					}
+				}
+
+				auto& pass_node = pass_nodes_[execution_order_[position]];
+				for (auto handle : pass_node.reads)
+				{
+					last_use[resource_nodes_[handle].rid] = position;
+				}
+
+				for (auto handle : pass_node.writes)
+				{
+					last_use[resource_nodes_[handle].rid] = position;
+				}
+			}
+		};
+
+		// counting sort of the split barriers by the position they begin at
+		for_each_split([&](FrameGraphBarrier& barrier, uint32_t, uint32_t begin, uint32_t)
+		{
+			barrier.split_begin = begin;
+			++split_begin_offsets_[begin + 1];
+		});
+
+		for (size_t i = 1; i < split_begin_offsets_.size(); ++i)
+		{
+			split_begin_offsets_[i] += split_begin_offsets_[i - 1];
+		}
+
+		split_begins_.resize(split_begin_offsets_.back());
+
+		std::vector<uint32_t> cursors(split_begin_offsets_.begin(), split_begin_offsets_.end() - 1);
+		for_each_split([&](FrameGraphBarrier&, uint32_t index, uint32_t begin, uint32_t end)
+		{
+			split_begins_[cursors[begin]++] = { index, end };
+		});
+	}
+
+	void FrameGraph::PlanSubmissions()
+	{
+		submissions_.clear();
+		submission_waits_.clear();
+		pass_submissions_.assign(pass_nodes_.size(), ~0u);
+
+		constexpr uint32_t kNumQueues = static_cast<uint32_t>(rhi::CommandListType::kCopy) + 1;
+		constexpr uint32_t kNone = ~0u;
+
+		// submissions that last wrote and read every resource, reads are kept per queue
+		std::vector<uint32_t> last_write(resources_.size(), kNone);
+		std::vector<std::array<uint32_t, kNumQueues>> last_reads(resources_.size());
+		for (auto& reads : last_reads)
+		{
+			reads.fill(kNone);
+		}
+
+		// submission + 1 of every other queue a queue already waited for, the wait covers everything before it
+		std::array<std::array<uint32_t, kNumQueues>, kNumQueues> waited{};
+		std::array<uint32_t, kNumQueues> waits;
+
+		// the previous pass is read back, the cpu waits for the end of its submission
+		bool split = false;
+
+		for (uint32_t position = 0; position < execution_order_.size(); ++position)
+		{
+			auto& pass_node = pass_nodes_[execution_order_[position]];
+			auto queue = static_cast<uint32_t>(pass_node.queue);
+
+			waits.fill(0);
+			auto depend = [&](uint32_t submission)
+			{
+				if (submission == kNone)
+				{
+					return;
+				}
+
+				auto other = static_cast<uint32_t>(submissions_[submission].queue);
+				if (other != queue)
+				{
+					waits[other] = std::max(waits[other], submission + 1);
+				}
+			};
+
+			for (auto handle : pass_node.reads)
+			{
+				depend(last_write[resource_nodes_[handle].rid]);
+			}
+
+			for (auto handle : pass_node.writes)
+			{
+				auto rid = resource_nodes_[handle].rid;
+				depend(last_write[rid]);
+				for (auto read : last_reads[rid])
+				{
+					depend(read);
+				}
+			}
+
+			// the transitions recorded after the pass order like writes of it
+			for (uint32_t i = post_barrier_offsets_[position]; i < post_barrier_offsets_[position + 1]; ++i)
+			{
+				auto rid = post_barriers_[i].rid;
+				depend(last_write[rid]);
+				for (auto read : last_reads[rid])
+				{
+					depend(read);
+				}
+			}
+
+			bool need_wait = false;
+			for (uint32_t other = 0; other < kNumQueues; ++other)
+			{
+				if (waits[other] > waited[queue][other])
+				{
+					need_wait = true;
+				}
+				else
+				{
+					waits[other] = 0;
+				}
+			}
+
+			// a wait applies to the whole submission, so it starts a new one instead of stalling the passes before it
+			if (submissions_.empty() || submissions_.back().queue != pass_node.queue || need_wait || split)
+			{
+				FrameGraphSubmission submission;
+				submission.queue = pass_node.queue;
+				submission.begin = position;
+				submission.end = position;
+				submission.wait_offset = static_cast<uint32_t>(submission_waits_.size());
+				submission.num_waits = 0;
+
+				for (uint32_t other = 0; other < kNumQueues; ++other)
+				{
+					if (waits[other] != 0)
+					{
+						submission_waits_.push_back(waits[other] - 1);
+						++submission.num_waits;
+						waited[queue][other] = waits[other];
+					}
+				}
+
+				submissions_.push_back(submission);
+			}
+
+			auto index = static_cast<uint32_t>(submissions_.size() - 1);
+			submissions_.back().end = position + 1;
+			pass_submissions_[pass_node.id] = index;
+			split = pass_node.readback;
+
+			for (auto handle : pass_node.reads)
+			{
+				last_reads[resource_nodes_[handle].rid][queue] = index;
+			}
+
+			for (auto handle : pass_node.writes)
+			{
+				last_write[resource_nodes_[handle].rid] = index;
+			}
+
+			for (uint32_t i = post_barrier_offsets_[position]; i < post_barrier_offsets_[position + 1]; ++i)
+			{
+				last_write[post_barriers_[i].rid] = index;
+			}
+		}
+	}
+
+	void FrameGraph::PlanRenderPasses()
+	{
+		render_passes_.clear();
+		render_pass_attachments_.clear();
+		pass_render_passes_.assign(pass_nodes_.size(), kInvalidRenderPass);
+
+		std::vector<FrameGraphAttachment> attachments;
+		for (uint32_t position = 0; position < execution_order_.size(); ++position)
+		{
+			auto& pass_node = pass_nodes_[execution_order_[position]];
+
+			// colors in write order, at most one depth
+			attachments.clear();
+			uint32_t num_colors = 0;
+			for (size_t i = 0; i < pass_node.writes.size(); ++i)
+			{
+				auto& resource_node = resource_nodes_[pass_node.writes[i]];
+				auto access = pass_node.write_accesses[i];
+
+				if ((access & FrameGraphAccess::kDepthWrite) != 0)
+				{
+					attachments.push_back({ resource_node.rid, rhi::AttachmentPoint::kDepthStencil, resource_node.range });
+				}
+				else if ((access & FrameGraphAccess::kRenderTarget) != 0)
+				{
+					CHECK(num_colors < static_cast<uint32_t>(rhi::AttachmentPoint::kDepthStencil), "too many color attachments");
+					attachments.push_back({ resource_node.rid, static_cast<rhi::AttachmentPoint>(num_colors++), resource_node.range });
+				}
+			}
+
+			if (attachments.empty())
+			{
+				continue;
+			}
+
+			if (CanMergeRenderPass(pass_node, position, attachments))
+			{
+				render_passes_.back().end = position + 1;
+			}
+			else
+			{
+				FrameGraphRenderPass render_pass;
+				render_pass.begin = position;
+				render_pass.end = position + 1;
+				render_pass.attachment_offset = static_cast<uint32_t>(render_pass_attachments_.size());
+				render_pass.num_attachments = static_cast<uint32_t>(attachments.size());
+
+				render_pass_attachments_.insert(render_pass_attachments_.end(), attachments.begin(), attachments.end());
+				render_passes_.push_back(render_pass);
+			}
+
+			pass_render_passes_[pass_node.id] = static_cast<uint32_t>(render_passes_.size() - 1);
+		}
+	}
+
+	bool FrameGraph::CanMergeRenderPass(const PassNode& pass_node, uint32_t position, const std::vector<FrameGraphAttachment>& attachments) const
+	{
+		if (render_passes_.empty() || render_passes_.back().end != position)
+		{
+			return false;
+		}
+
+		const auto& previous = pass_nodes_[execution_order_[position - 1]];
+		if (previous.queue != pass_node.queue)
+		{
+			return false;
+		}
+
+		const auto& render_pass = render_passes_.back();
+		if (render_pass.num_attachments != attachments.size())
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0; i < render_pass.num_attachments; ++i)
+		{
+			if (render_pass_attachments_[render_pass.attachment_offset + i] != attachments[i])
+			{
+				return false;
+			}
+		}
+
+		// a transition of an attachment ends the render pass
+		for (uint32_t i = barrier_offsets_[position]; i < barrier_offsets_[position + 1]; ++i)
+		{
+			for (auto& attachment : attachments)
+			{
+				if (barriers_[i].rid == attachment.rid)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	void FrameGraph::PlanDescriptorTables()
+	{
+		descriptors_.clear();
+		descriptor_offsets_.assign(pass_nodes_.size() + 1, 0);
+
+		for (auto& pass_node : pass_nodes_)
+		{
+			descriptor_offsets_[pass_node.id] = static_cast<uint32_t>(descriptors_.size());
+			if (!pass_node.CanExecute())
+			{
+				continue;
+			}
+
+			for (size_t i = 0; i < pass_node.reads.size(); ++i)
+			{
+				auto access = pass_node.read_accesses[i];
+				if ((access & (FrameGraphAccess::kShaderResource | FrameGraphAccess::kUnorderedAccess)) == 0)
+				{
+					continue;
+				}
+
+				auto rid = resource_nodes_[pass_node.reads[i]].rid;
+				auto range = pass_node.read_ranges[i].Resolve(resources_[rid].GetSubresources());
+				descriptors_.push_back({ pass_node.reads[i], rid, range, (access & FrameGraphAccess::kShaderResource) == 0 });
+			}
+
+			for (size_t i = 0; i < pass_node.writes.size(); ++i)
+			{
+				if ((pass_node.write_accesses[i] & FrameGraphAccess::kUnorderedAccess) == 0)
+				{
+					continue;
+				}
+
+				auto& resource_node = resource_nodes_[pass_node.writes[i]];
+				auto range = resource_node.range.Resolve(resources_[resource_node.rid].GetSubresources());
+				descriptors_.push_back({ resource_node.id, resource_node.rid, range, true });
+			}
+		}
+
+		descriptor_offsets_[pass_nodes_.size()] = static_cast<uint32_t>(descriptors_.size());
+
+		descriptor_tables_.assign(pass_nodes_.size(), nullptr);
+		descriptor_table_resources_.assign(descriptors_.size(), nullptr);
+	}
+
+	void FrameGraph::BakeDescriptorTables(rhi::Device* device)
+	{
+		if (descriptor_table_device_ != device)
+		{
+			std::fill(descriptor_tables_.begin(), descriptor_tables_.end(), nullptr);
+			descriptor_table_device_ = device;
+		}
+
+		if (!device)
+		{
+			return;
+		}
+
+		for (auto id : execution_order_)
+		{
+			auto begin = descriptor_offsets_[id];
+			auto end = descriptor_offsets_[id + 1];
+			if (begin == end)
+			{
+				continue;
+			}
+
+			bool changed = !descriptor_tables_[id];
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				rhi::ResourceBarrier barrier;
+				resources_[descriptors_[i].rid].FillBarrier(barrier);
+
+				rhi::Resource* resource = barrier.texture ? static_cast<rhi::Resource*>(barrier.texture) : barrier.buffer;
+				changed = changed || descriptor_table_resources_[i] != resource;
+				descriptor_table_resources_[i] = resource;
+			}
+
+			if (!changed)
+			{
+				continue;
+			}
+
+			// a table the gpu may still read is never rewritten, the command lists that bound it keep it alive
+			auto table = device->CreateDescriptorTable(end - begin);
+			if (!table)
+			{
+				return;
+			}
+
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				const auto& descriptor = descriptors_[i];
+				const auto& range = descriptor.range;
+				auto index = i - begin;
+
+				rhi::ResourceBarrier barrier;
+				resources_[descriptor.rid].FillBarrier(barrier);
+
+				if (barrier.texture)
+				{
+					const auto& desc = barrier.texture->GetDesc();
+					if (descriptor.unordered_access)
+					{
+						table->SetUnorderedAccessView(index, barrier.texture, desc.format, desc.dimension, range.first_mip, range.first_slice, range.num_slices);
+					}
+					else
+					{
+						table->SetShaderResourceView(index, barrier.texture, desc.format, desc.dimension, range.first_mip, range.num_mips, range.first_slice, range.num_slices);
+					}
+				}
+				else if (barrier.buffer)
+				{
+					auto size = barrier.buffer->GetDesc().size_in_bytes;
+					if (descriptor.unordered_access)
+					{
+						table->SetUnoderedAccessBufferView(index, barrier.buffer, 0, size);
+					}
+					else
+					{
+						table->SetStructuredBufferView(index, barrier.buffer, 0, size);
+					}
+				}
+			}
+
+			descriptor_tables_[id] = std::move(table);
+		}
+	}
+
+	rhi::DescriptorTable* FrameGraph::GetDescriptorTable(uint32_t pass_id) const
+	{
+		return pass_id < descriptor_tables_.size() ? descriptor_tables_[pass_id].Get() : nullptr;
+	}
+
+	const rhi::RenderTarget* FrameGraph::GetRenderTarget(uint32_t pass_id) const
+	{
+		auto render_pass = pass_render_passes_[pass_id];
+		if (render_pass == kInvalidRenderPass || render_pass >= render_targets_.size())
+		{
+			return nullptr;
+		}
+
+		return &render_targets_[render_pass];
+	}
+
+	FrameGraphPassResources::FrameGraphPassResources(FrameGraph& framegraph, PassNode& pass_node)
+		: framegraph_(framegraph)
+		, pass_node_(pass_node)
+	{
+
+	}
+
+	uint32_t FrameGraphPassResources::GetDescriptorIndex(FrameGraphHandle handle) const
+	{
+		auto begin = framegraph_.descriptor_offsets_[pass_node_.id];
+		auto end = framegraph_.descriptor_offsets_[pass_node_.id + 1];
+		handle = MapHandle(handle);
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			if (framegraph_.descriptors_[i].handle == handle)
+			{
+				return i - begin;
+			}
+		}
 
+		return ~0u;
 	}
 }
\ No newline at end of file
@@ -1,23 +1,160 @@
 #pragma once
 
 #include <memory>
-#include <any>
-#include <typeindex>
-#include <unordered_map>
+#include <array>
+#include <atomic>
+#include <initializer_list>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "pass_node.h"
 #include "resource_node.h"
 #include "framegraph_pass.h"
+#include "frame_arena.h"
+#include "framegraph_resource_pool.h"
 
 #include "rhi/device.h"
 #include "rhi/command_list.h"
+#include "rhi/render_target.h"
 
 namespace light::fg
 {
+	// Transition planned by Compile, before == after == kUnorderedAccess is an uav barrier.
+	// The resource is idle from position split_begin on, the transition may begin there, ~0u if it can't be split
+	struct FrameGraphBarrier
+	{
+		uint32_t rid;
+		rhi::ResourceStates before;
+		rhi::ResourceStates after;
+		uint32_t subresource = ~0u;		// mip + slice * num_mips, ~0u for all of them
+		uint32_t split_begin = ~0u;
+	};
+
+	// Contiguous run of the execution order submitted to one queue,
+	// waits_[wait_offset, wait_offset + num_waits) are indices of earlier submissions it has to wait for
+	struct FrameGraphSubmission
+	{
+		rhi::CommandListType queue;
+		uint32_t begin;
+		uint32_t end;
+		uint32_t wait_offset;
+		uint32_t num_waits;
+	};
+
+	struct FrameGraphAttachment
+	{
+		uint32_t rid;
+		rhi::AttachmentPoint point;
+		FrameGraphSubresourceRange range;	// the first mip and slice are bound
+
+		bool operator==(const FrameGraphAttachment& other) const
+		{
+			return rid == other.rid && point == other.point && range == other.range;
+		}
+
+		bool operator!=(const FrameGraphAttachment& other) const { return !(*this == other); }
+	};
+
+	// Consecutive passes of the execution order [begin, end) writing the same attachments,
+	// the graph binds the render target once at begin and the passes only draw.
+	// attachments_[attachment_offset, attachment_offset + num_attachments)
+	struct FrameGraphRenderPass
+	{
+		uint32_t begin;
+		uint32_t end;
+		uint32_t attachment_offset;
+		uint32_t num_attachments;
+	};
+
+	// View of a pass in its prebaked descriptor table, the reads with shader resource or unordered access
+	// in declaration order followed by the unordered access writes
+	struct FrameGraphDescriptor
+	{
+		FrameGraphHandle handle;
+		uint32_t rid;
+		FrameGraphSubresourceRange range;	// resolved
+		bool unordered_access;
+	};
+
+	// Execution order before and after the barrier minimizing scheduler and the barriers each one needs,
+	// both orders are the same while scheduling is disabled. counted right after scheduling, before submission
+	// batching and kSerialize move passes again
+	struct FrameGraphScheduleStats
+	{
+		std::vector<uint32_t> declaration_order;
+		uint32_t num_declaration_barriers = 0;
+		uint32_t num_scheduled_barriers = 0;
+	};
+
+	// What happens when the estimated transient memory of the compiled graph exceeds the budget
+	enum class FrameGraphBudgetPolicy : uint8_t
+	{
+		// Execute throws FrameGraphBudgetExceeded before it realizes anything
+		kFail,
+		// Compile moves the passes that would overlap more lifetimes than the budget holds behind ones freeing memory,
+		// giving up the barrier schedule and the queue batching there. Execute still throws if that is not enough
+		kSerialize,
+	};
+
+	// Transient bytes Execute holds for a frame, the objects it realizes sized by the desc sizes.
+	// Resources taking over the pooled object of an earlier one share its bytes
+	struct FrameGraphMemoryEstimate
+	{
+		uint64_t peak_bytes = 0;
+		uint32_t peak_position = 0;				// position of the pass realizing the last new object
+		uint64_t unserialized_peak_bytes = 0;	// before kSerialize reordered the passes
+		uint32_t num_serialized_passes = 0;		// passes kSerialize picked ahead of the earlier ones of the scheduled order
+		std::vector<uint32_t> peak_rids;		// transient resources realizing a new object, largest first
+	};
+
+	// thrown by Execute, what() is GetMemoryReport with every resource realizing an object and its size
+	class FrameGraphBudgetExceeded : public std::runtime_error
+	{
+	public:
+		using std::runtime_error::runtime_error;
+	};
+
+	// Persistent id of a history resource, valid until ReleaseHistory
+	using FrameGraphHistoryId = uint32_t;
+
+	// Both versions of a history resource in the current graph,
+	// current is written this frame and is read as previous by the next one
+	struct FrameGraphHistory
+	{
+		FrameGraphHandle current;
+		FrameGraphHandle previous;
+		bool previous_valid;	// false until a frame wrote the history, e.g. to reset taa
+	};
+
+	class FrameGraphTemplate;
+
+	// Passes and resources of a template added by FrameGraph::Instantiate, valid until the next Clear
+	struct FrameGraphInstance
+	{
+		uint32_t id;						// FrameGraphPassResources::GetInstance of its passes
+		const FrameGraphHandle* handles;	// graph handle of every template handle, the parameters map to the bound handles
+
+		// e.g. the last version of a parameter written by the template
+		FrameGraphHandle operator[](FrameGraphHandle handle) const { return handles[handle]; }
+	};
+
+	// CPU cost of a pass in the last frame, times are only recorded while profiling is enabled
+	struct FrameGraphPassStats
+	{
+		uint64_t setup_ns = 0;
+		uint64_t execute_ns = 0;
+		uint32_t num_created = 0;
+		// created resources that took over the pooled object of an earlier one
+		uint32_t num_reused = 0;
+	};
+
 	class FrameGraph
 	{
 	public:
 		friend class FrameGraphPassResources;
+		friend class FrameGraphTemplate;
 
 		class Blackbord
 		{
@@ -34,23 +171,25 @@ namespace light::fg
 			template<typename Data>
 			void Add(Data&& data)
 			{
-				storage_.emplace(typeid(Data), std::forward<Data>(data));
+				GetSlot<std::decay_t<Data>>().value = std::forward<Data>(data);
 			}
 
 			template<typename Data>
 			Data& Get()
 			{
-				auto it = storage_.find(typeid(Data));
-				return std::any_cast<const Data&>(it->second);
+				auto* data = TryGet<Data>();
+				CHECK(data, "blackboard has no entry of this type");
+				return *data;
 			}
 
 			template<typename Data>
 			Data* TryGet()
 			{
-				auto it = storage_.find(typeid(Data));
-				if (it != storage_.end())
+				auto id = GetSlotId<Data>();
+				if (id < slots_.size() && slots_[id])
 				{
-					return &std::any_cast<Data>(it->second);
+					auto& value = static_cast<Slot<Data>*>(slots_[id].get())->value;
+					return value ? &*value : nullptr;
 				}
 
 				return nullptr;
@@ -59,10 +198,69 @@ namespace light::fg
 			template<typename Data>
 			bool Contains() const
 			{
-				return storage_.find(typeid(Data)) != storage_.end();
+				auto id = GetSlotId<Data>();
+				return id < slots_.size() && slots_[id] && static_cast<const Slot<Data>*>(slots_[id].get())->value;
+			}
+
+			// empties the entries, the slots stay allocated for the next frame
+			void Clear()
+			{
+				for (auto& slot : slots_)
+				{
+					if (slot)
+					{
+						slot->Reset();
+					}
+				}
 			}
 		private:
-			std::unordered_map<std::type_index, std::any> storage_;
+			struct SlotConcept
+			{
+				virtual ~SlotConcept() = default;
+
+				virtual void Reset() = 0;
+			};
+
+			template<typename Data>
+			struct Slot final : public SlotConcept
+			{
+				void Reset() override { value.reset(); }
+
+				std::optional<Data> value;
+			};
+
+			static uint32_t NextSlotId()
+			{
+				static std::atomic_uint32_t next_id = 0;
+				return next_id++;
+			}
+
+			// assigned on first use, indexes slots_ of every blackboard
+			template<typename Data>
+			static uint32_t GetSlotId()
+			{
+				static const uint32_t id = NextSlotId();
+				return id;
+			}
+
+			template<typename Data>
+			Slot<Data>& GetSlot()
+			{
+				auto id = GetSlotId<Data>();
+				if (id >= slots_.size())
+				{
+					slots_.resize(id + 1);
+				}
+
+				if (!slots_[id])
+				{
+					slots_[id] = std::make_unique<Slot<Data>>();
+				}
+
+				return *static_cast<Slot<Data>*>(slots_[id].get());
+			}
+
+			std::vector<std::unique_ptr<SlotConcept>> slots_;
 		};
 
 		class Builder
@@ -73,13 +271,29 @@ namespace light::fg
 			template<typename T>
 			FrameGraphHandle Create(std::string_view name, typename T::Desc&& desc)
 			{
-				return CreateFrameGraphResource(name, std::forward<typename T::Desc>(desc));
+				auto handle = framegraph_.CreateFrameGraphResource<T>(name, std::move(desc), T{});
+				return pass_node_.Create(handle);
 			}
 
-			FrameGraphHandle Read(FrameGraphHandle handle);
-			FrameGraphHandle Write(FrameGraphHandle handle);
+			// reads the subresources of the handle, the access drives the planned barriers and has to be named,
+			// pooled resources get no transitions besides them
+			FrameGraphHandle Read(FrameGraphHandle handle, FrameGraphAccess access);
+
+			// reads only a range of the subresources, e.g. one mip of a mip chain written by earlier passes
+			FrameGraphHandle Read(FrameGraphHandle handle, FrameGraphAccess access, const FrameGraphSubresourceRange& range);
+
+			// writes the subresources of the handle
+			FrameGraphHandle Write(FrameGraphHandle handle, FrameGraphAccess access);
+
+			// writes a range and returns a new version covering only it, the other subresources keep their
+			// versions so a pass can read mip n while writing mip n + 1 of the same texture
+			FrameGraphHandle Write(FrameGraphHandle handle, FrameGraphAccess access, const FrameGraphSubresourceRange& range);
 
 			void SetSideEffect();
+
+			// the cpu reads the results of the pass this frame, its submission ends right after it
+			// so FrameGraph::GetFenceValue is signaled without waiting for the passes behind it
+			void SetReadback();
 		private:
 			FrameGraph& framegraph_;
 			PassNode& pass_node_;
@@ -89,55 +303,414 @@ namespace light::fg
 		void Clear();
 
 		template<typename T>
-		FrameGraphHandle Import(std::string_view name, typename T::Desc&& desc)
+		FrameGraphHandle Import(std::string_view name, typename T::Desc&& desc, T&& resource)
+		{
+			return CreateFrameGraphResource<T>(name, std::move(desc), std::move(resource), true);
+		}
+
+		// Two resources of T kept alive across Clear and swapped by every Execute, for taa, exposure and other temporal data.
+		// They are realized once, never aliased, and the states they are left in carry over into the barriers of the next frame.
+		template<typename T>
+		FrameGraphHistoryId CreateHistory(std::string_view name, typename T::Desc&& desc)
 		{
-			return CreateFrameGraphResource(name, std::forward<typename T::Desc>(desc),true);
+			typename T::Desc previous_desc = desc;
+
+			HistoryResource history;
+			history.name = name;
+			history.models[0] = std::make_unique<FrameGraphResource::Model<T>>(std::move(previous_desc), T{});
+			history.models[1] = std::make_unique<FrameGraphResource::Model<T>>(std::move(desc), T{});
+
+			return AddHistory(std::move(history));
 		}
 
+		// gives the resources back to the pool, not allowed between UseHistory and Execute
+		void ReleaseHistory(FrameGraphHistoryId id);
+
+		// adds both versions to the current graph, a pass writing current is never culled
+		FrameGraphHistory UseHistory(FrameGraphHistoryId id);
+
 		template<typename Data,typename Setup,typename Execute>
-		const Data& AddPass(std::string_view name,Setup&& setup, Execute&& execute)
+		const Data& AddPass(std::string_view name,Setup&& setup, Execute&& execute, rhi::CommandListType queue = rhi::CommandListType::kDirect)
 		{
-			static_assert(std::is_invocable_v<Setup, Builder, Data>, "invalid setup callback");
+			static_assert(std::is_invocable_v<Setup, Builder&, Data&>, "invalid setup callback");
 			static_assert(std::is_invocable_v<Execute, const Data&,
 				FrameGraphPassResources&, rhi::Device*, rhi::CommandList*>, "invalid execute callback");
 
-			auto* pass = new FrameGraphPass<Data, Execute>(std::forward<Execute>(execute));
-			std::unique_ptr<FrameGraphPassConcept> pass_concept(pass);
+			auto* pass = arena_.New<FrameGraphPass<Data, Execute>>(std::forward<Execute>(execute));
 
-			auto& pass_node = CreatePassNode(name, std::move(pass_concept));
+			auto& pass_node = CreatePassNode(name, queue, pass);
+
+			auto setup_begin = GetProfilingTimestamp();
 
 			Builder builder(*this, pass_node);
 			std::invoke(setup, builder, pass->data);
+
+			pass_stats_[pass_node.id].setup_ns = GetProfilingTimestamp() - setup_begin;
 			
 			return pass->data;
 		}
 
+		// Adds the passes of a template without running their setup callbacks, parameters[i] is bound to parameter i.
+		// Writes of a parameter add new versions of the bound resource, read them through the returned instance
+		FrameGraphInstance Instantiate(const FrameGraphTemplate& subgraph, const FrameGraphHandle* parameters, uint32_t num_parameters);
+
+		FrameGraphInstance Instantiate(const FrameGraphTemplate& subgraph, std::initializer_list<FrameGraphHandle> parameters)
+		{
+			return Instantiate(subgraph, parameters.begin(), static_cast<uint32_t>(parameters.size()));
+		}
+
+		// Skips culling and planning when the graph has the same structure as the last compiled one
 		void Compile();
 		
+		// Records the passes on up to max recording threads, one command list per contiguous chunk,
+		// and submits them to the queues of their passes with gpu waits between dependent queues
 		void Execute(rhi::Device* device);
+
+		// 0 uses every hardware thread
+		void SetMaxRecordingThreads(uint32_t num_threads);
+
+		// Compile reorders independent passes to group readers of the same state and to move
+		// consumers away from their producers, off by default so passes run in declaration order
+		void SetSchedulingEnabled(bool enabled) { scheduling_enabled_ = enabled; }
+
+		const FrameGraphScheduleStats& GetScheduleStats() const { return schedule_stats_; }
+
+		// Compile groups the passes of each queue together where the hazards allow it, so a frame using several queues
+		// is submitted in as few ExecuteCommandLists calls as possible. on by default, a single queue graph keeps its order
+		void SetSubmissionBatchingEnabled(bool enabled) { submission_batching_enabled_ = enabled; }
+
+		// ExecuteCommandLists calls of every Execute of the compiled graph
+		uint32_t GetNumSubmissions() const { return static_cast<uint32_t>(submissions_.size()); }
+
+		// fence value the queue of the pass signals once its submission completed in the last Execute, 0 if it didn't run
+		uint64_t GetFenceValue(uint32_t pass_id) const;
+
+		// 0 disables the budget, changing it invalidates the compile cache
+		void SetMemoryBudget(uint64_t bytes, FrameGraphBudgetPolicy policy = FrameGraphBudgetPolicy::kFail);
+
+		const FrameGraphMemoryEstimate& GetMemoryEstimate() const { return memory_estimate_; }
+
+		bool IsOverMemoryBudget() const { return memory_budget_ > 0 && memory_estimate_.peak_bytes > memory_budget_; }
+
+		// the estimate of the last Compile and the resources realizing its objects, one per line
+		std::string GetMemoryReport() const;
+
+		uint32_t GetNumBarriers() const { return static_cast<uint32_t>(barriers_.size() + post_barriers_.size()); }
+
+		// barriers beginning right after the last pass using their resource and ending before the next one,
+		// recorded as a full transition when both halves don't end up in the same command list
+		uint32_t GetNumSplitBarriers() const { return static_cast<uint32_t>(split_begins_.size()); }
+
+		// pass ids of the executed passes in submission order
+		const std::vector<uint32_t>& GetExecutionOrder() const { return execution_order_; }
+
+		const std::vector<FrameGraphSubmission>& GetSubmissions() const { return submissions_; }
+
+		const std::vector<uint32_t>& GetSubmissionWaits() const { return submission_waits_; }
+
+		// passes writing kRenderTarget/kDepthWrite grouped into render passes, a group of more than one pass is a merge
+		const std::vector<FrameGraphRenderPass>& GetRenderPasses() const { return render_passes_; }
+
+		const std::vector<FrameGraphAttachment>& GetRenderPassAttachments() const { return render_pass_attachments_; }
+
+		// render pass of a pass, kInvalidRenderPass if it writes no attachments
+		uint32_t GetRenderPass(uint32_t pass_id) const { return pass_render_passes_[pass_id]; }
+
+		static constexpr uint32_t kInvalidRenderPass = ~0u;
+
+		// true if the last Compile reused the plan of the previous graph
+		bool IsCompileCached() const { return compile_cached_; }
+
+		// forces the next Compile to plan from scratch
+		void InvalidateCompileCache() { compiled_graph_.valid = false; }
+
+		void SetProfilingEnabled(bool enabled) { profiling_enabled_ = enabled; }
+
+		// gpu objects of FrameGraphTexture/FrameGraphBuffer, kept across frames
+		FrameGraphResourcePool& GetResourcePool() { return resource_pool_; }
+
+		// indexed by pass id, valid until the next Clear
+		const std::vector<FrameGraphPassStats>& GetPassStats() const { return pass_stats_; }
+
+		// the compiled graph with culled passes, resource lifetimes and memory sizes annotated
+		std::string ExportGraphviz() const;
+		std::string ExportJson() const;
 	private:
 		template<typename T>
-		FrameGraphHandle CreateFrameGraphResource(std::string_view name, typename T::Desc&& desc,bool import = false)
+		FrameGraphHandle CreateFrameGraphResource(std::string_view name, typename T::Desc&& desc, T&& resource, bool import = false)
 		{
-			auto rid = resources_.size();
-			resources_.emplace_back(rid, std::forward<typename T::Desc>(desc), 0,import);
+			auto rid = static_cast<uint32_t>(resources_.size());
+			auto* model = arena_.New<FrameGraphResource::Model<T>>(std::move(desc), std::move(resource));
+			resources_.emplace_back(rid, model, 0, import);
 
-			auto& node = CreateResourceNode(name, rid,0);
+			auto& node = CreateResourceNode(arena_.CopyString(name), rid,0);
 
 			return node.id;
 		}
 
-		PassNode& CreatePassNode(std::string_view name, std::unique_ptr<FrameGraphPassConcept> pass);
+		PassNode& CreatePassNode(std::string_view name, rhi::CommandListType queue, FrameGraphPassConcept* pass);
 		
-		ResourceNode& CreateResourceNode(std::string_view name,uint32_t rid,uint32_t version);
+		ResourceNode& CreateResourceNode(std::string_view name,uint32_t rid,uint32_t version, const FrameGraphSubresourceRange& range = {});
+
+		// pooled resources used on one queue take over the objects of earlier ones with the same desc once their lifetime ended
+		void PlanObjectReuse();
 
-		FrameGraphHandle CreateNewVersionNode(FrameGraphHandle handle);
+		FrameGraphHandle CreateNewVersionNode(FrameGraphHandle handle, const FrameGraphSubresourceRange& range);
+
+		// orders the pass after the versions last written over the range, from handle back
+		void ReadVersions(PassNode& pass_node, FrameGraphHandle handle, const FrameGraphSubresourceRange& range);
 
 		FrameGraphResource& GetFrameGraphResource(FrameGraphHandle handle);
 
+		struct HistoryResource
+		{
+			std::string name;
+			std::array<std::unique_ptr<FrameGraphResource::Concept>, 2> models;
+			std::array<rhi::ResourceStates, 2> states = { rhi::ResourceStates::kCommon, rhi::ResourceStates::kCommon };
+			std::array<bool, 2> created = { false, false };
+			uint32_t current = 0;		// slot written this frame
+			bool previous_valid = false;
+			std::optional<FrameGraphHistory> frame;		// handles in the current graph, reset by Clear
+		};
+
+		// history slot behind a resource of the current graph
+		struct HistoryUse
+		{
+			uint32_t history;
+			uint32_t slot;
+			uint32_t rid;
+		};
+
+		FrameGraphHistoryId AddHistory(HistoryResource&& history);
+
+		// realizes the used history slots, the first frame on a device creates them
+		void RealizeHistories(rhi::Device* device);
+
+		// stores the states the frame left the histories in and swaps current and previous
+		void SwapHistories();
+
+		// pass names, edges, accesses, queues and resource descs, everything the compiled plan depends on
+		size_t ComputeStructureHash() const;
+
+		void SaveCompiledGraph(size_t hash);
+
+		void RestoreCompiledGraph();
+
+		// first and last executed pass of every resource
+		void AssignResourceLifetimes();
+
+		void PlanResourceLifetimes();
+
+		// bytes of the objects Execute realizes, sized by GetMemorySize, after PlanResourceLifetimes
+		void EstimateMemory();
+
+		struct PassUsage
+		{
+			uint32_t rid;
+			FrameGraphSubresourceRange range;	// resolved
+			rhi::ResourceStates state;
+			bool write;
+		};
+
+		// state every subresource is left in by the passes tracked so far,
+		// subresource s of resource i is at subresource_offsets[i] + s, s = mip + slice * num_mips
+		struct BarrierTracker
+		{
+			std::vector<uint32_t> subresource_offsets;
+			std::vector<FrameGraphSubresources> subresources;
+			std::vector<rhi::ResourceStates> states;
+			std::vector<bool> unordered_access_written;
+
+			// state the tracked pass needs, valid where pass_stamps == stamp
+			std::vector<rhi::ResourceStates> pass_states;
+			std::vector<bool> pass_writes;
+			std::vector<uint32_t> pass_stamps;
+			uint32_t stamp = 0;
+		};
+
+		// writes come first, reads of the same range are merged
+		void CollectPassUsages(const PassNode& pass_node, std::vector<PassUsage>& usages) const;
+
+		// resources start in kCommon, histories in the state the last frame left them in
+		void ResetBarrierTracker(BarrierTracker& tracker) const;
+
+		// subresources of the usage that need a transition or an uav barrier
+		static uint32_t CountBarriers(const BarrierTracker& tracker, const PassUsage& usage);
+
+		template<typename Function>
+		static void ForEachSubresource(const BarrierTracker& tracker, const PassUsage& usage, Function&& function)
+		{
+			auto offset = tracker.subresource_offsets[usage.rid];
+			auto num_mips = tracker.subresources[usage.rid].num_mips;
+			for (uint32_t slice = usage.range.first_slice; slice < usage.range.first_slice + usage.range.num_slices; ++slice)
+			{
+				for (uint32_t mip = usage.range.first_mip; mip < usage.range.first_mip + usage.range.num_mips; ++mip)
+				{
+					function(offset + mip + slice * num_mips, mip + slice * num_mips);
+				}
+			}
+		}
+
+		static void TrackPassUsages(const std::vector<PassUsage>& usages, BarrierTracker& tracker, std::vector<FrameGraphBarrier>& barriers);
+
+		// hazards between the passes of execution_order_, read after write, write after read and write after write,
+		// side effect passes also keep their relative order. successors of pass i are successors[successor_offsets[i], successor_offsets[i + 1])
+		struct HazardGraph
+		{
+			std::vector<uint32_t> successor_offsets;
+			std::vector<uint32_t> successors;
+			std::vector<uint32_t> num_predecessors;
+		};
+
+		void BuildHazardGraph(HazardGraph& graph) const;
+
+		// greedy topological sort of execution_order_ keeping every hazard of the declaration order
+		void ScheduleExecutionOrder();
+
+		// transitions and uav barriers of execution_order_, before split barriers and pooled objects changing hands
+		uint32_t CountOrderBarriers() const;
+
+		// greedy topological sort keeping execution_order_ as long as the live transient bytes fit the limit,
+		// preferring the passes that allocate the fewest and free the most bytes where they don't
+		void ScheduleForMemory(uint64_t live_bytes_limit);
+
+		// interleaves the queues of execution_order_, staying on the queue of the previous pass as long as its next pass
+		// is ready. the passes of each queue keep their order, so the barriers the scheduler saved stay saved
+		void BatchSubmissions();
+
+		void PlanBarriers();
+
+		// transitions of the objects going back to the pool to the common state the next holder starts in
+		void PlanReleaseBarriers(const BarrierTracker& tracker, std::vector<std::pair<uint32_t, FrameGraphBarrier>>& post_barriers) const;
+
+		void PlanSplitBarriers();
+
+		void PlanSubmissions();
+
+		void PlanRenderPasses();
+
+		void PlanDescriptorTables();
+
+		// fills the tables of the executed passes, a table is only rebaked when a resource it views changed
+		void BakeDescriptorTables(rhi::Device* device);
+
+		rhi::DescriptorTable* GetDescriptorTable(uint32_t pass_id) const;
+
+		bool CanMergeRenderPass(const PassNode& pass_node, uint32_t position, const std::vector<FrameGraphAttachment>& attachments) const;
+
+		const rhi::RenderTarget* GetRenderTarget(uint32_t pass_id) const;
+
+		uint32_t GetMaxRecordingThreads() const;
+
+		// nanoseconds, 0 while profiling is disabled
+		uint64_t GetProfilingTimestamp() const;
+
+		// a pass opening a command list rebinds the render target of a merged render pass,
+		// split barriers are only split inside the chunk [chunk_begin, chunk_end) recorded into the list
+		void RecordPass(uint32_t position, uint32_t chunk_begin, uint32_t chunk_end, rhi::Device* device, rhi::CommandList* command_list, std::vector<rhi::ResourceBarrier>& barriers);
+
+		static constexpr uint32_t kMinPassesPerRecordingChunk = 8;
+
+		FrameGraphResourcePool resource_pool_;
+
+		// pass objects, their data, resource models, names and edge lists of the current graph,
+		// declared first so it outlives the nodes pointing into it
+		FrameArena arena_;
+
 		std::vector<FrameGraphResource> resources_;
 		std::vector<PassNode> pass_nodes_;
 		std::vector<ResourceNode> resource_nodes_;
+
+		std::vector<uint32_t> execution_order_;
+
+		// rids realized before pass i are [create_offsets_[i], create_offsets_[i + 1]) of create_rids_
+		std::vector<uint32_t> create_offsets_;
+		std::vector<uint32_t> create_rids_;
+
+		// resource whose pooled object create_rids_[i] takes over, ~0u if it gets one of its own. the object is given
+		// back to the pool right before, the last resource holding it releases it after the submit in release_rids_ order
+		std::vector<uint32_t> create_predecessors_;
+		std::vector<uint32_t> release_rids_;
+
+		// barriers of the pass at position i of the execution order are [barrier_offsets_[i], barrier_offsets_[i + 1])
+		std::vector<FrameGraphBarrier> barriers_;
+		std::vector<uint32_t> barrier_offsets_;
+
+		// recorded right after the pass at position i: the last use of a pooled object returns it to the common state,
+		// the last direct queue user leaves a resource in a state the compute or copy queue using it next can transition
+		std::vector<FrameGraphBarrier> post_barriers_;
+		std::vector<uint32_t> post_barrier_offsets_;
+
+		// barriers_ index of a split transition and the position it ends at
+		struct SplitBarrierBegin
+		{
+			uint32_t barrier;
+			uint32_t end;
+		};
+
+		// split barriers beginning at position i are [split_begin_offsets_[i], split_begin_offsets_[i + 1])
+		std::vector<SplitBarrierBegin> split_begins_;
+		std::vector<uint32_t> split_begin_offsets_;
+
+		std::vector<FrameGraphSubmission> submissions_;
+		std::vector<uint32_t> submission_waits_;
+
+		// submission of every pass, ~0u for culled passes, and the fence values the last Execute signaled
+		std::vector<uint32_t> pass_submissions_;
+		std::vector<uint64_t> submission_fence_values_;
+		bool submission_batching_enabled_ = true;
+
+		std::vector<FrameGraphRenderPass> render_passes_;
+		std::vector<FrameGraphAttachment> render_pass_attachments_;
+		std::vector<uint32_t> pass_render_passes_;
+
+		// views of the pass with id i are [descriptor_offsets_[i], descriptor_offsets_[i + 1])
+		std::vector<FrameGraphDescriptor> descriptors_;
+		std::vector<uint32_t> descriptor_offsets_;
+
+		// table of every pass and the rhi resource behind each of its views, kept across frames,
+		// a table holds its resources so an unchanged pointer is an unchanged resource
+		std::vector<rhi::DescriptorTableHandle> descriptor_tables_;
+		std::vector<rhi::Resource*> descriptor_table_resources_;
+		rhi::Device* descriptor_table_device_ = nullptr;
+
+		// persistent, released entries have no models and are reused by CreateHistory
+		std::vector<HistoryResource> histories_;
+		std::vector<HistoryUse> history_uses_;
+		rhi::Device* history_device_ = nullptr;
+
+		// state every history use is left in, planned with the barriers
+		std::vector<rhi::ResourceStates> history_final_states_;
+
+		// render targets of the render passes, rebuilt by every Execute
+		std::vector<rhi::RenderTarget> render_targets_;
+
+		// node state of the last compiled graph, the plans above survive Clear and are reused with it
+		struct CompiledGraph
+		{
+			bool valid = false;
+			size_t hash = 0;
+			std::vector<int32_t> pass_ref_counts;
+			std::vector<uint32_t> resource_producers;
+			std::vector<uint32_t> resource_lasts;
+		};
+
+		CompiledGraph compiled_graph_;
+		bool compile_cached_ = false;
+
+		uint32_t max_recording_threads_ = 0;
+
+		bool scheduling_enabled_ = false;
+		FrameGraphScheduleStats schedule_stats_;
+
+		std::vector<FrameGraphPassStats> pass_stats_;
+		bool profiling_enabled_ = false;
+
+		uint32_t num_instances_ = 0;
+
+		uint64_t memory_budget_ = 0;
+		FrameGraphBudgetPolicy budget_policy_ = FrameGraphBudgetPolicy::kFail;
+		FrameGraphMemoryEstimate memory_estimate_;
 	};	
 
 	class FrameGraphPassResources
@@ -152,20 +725,50 @@ namespace light::fg
 		FrameGraphPassResources& operator=(const FrameGraphPassResources&) = delete;
 		FrameGraphPassResources& operator=(FrameGraphPassResources&&) = delete;
 
+		// passes of a template instance take the handles of the template
 		template<typename T>
 		T& Get(FrameGraphHandle handle)
 		{
-			return framegraph_.GetFrameGraphResource(handle).Get();
+			return framegraph_.GetFrameGraphResource(MapHandle(handle)).Get<T>();
 		}
 
 		template<typename T>
-		typename T::Desc& GetDesc(FrameGraphHandle handle)
+		const typename T::Desc& GetDesc(FrameGraphHandle handle)
+		{
+			return framegraph_.GetFrameGraphResource(MapHandle(handle)).GetDesc<T>();
+		}
+
+		// bound by the graph before the pass runs, nullptr if the pass writes no attachments
+		const rhi::RenderTarget* GetRenderTarget() const
+		{
+			return framegraph_.GetRenderTarget(pass_node_.id);
+		}
+
+		// subresources a handle covers, kAll counts run to the end of the resource
+		const FrameGraphSubresourceRange& GetSubresourceRange(FrameGraphHandle handle) const
+		{
+			return framegraph_.resource_nodes_[MapHandle(handle)].range;
+		}
+
+		// srv/uav views of the pass baked once when its resources are realized, bind it instead of staging the views one by one,
+		// nullptr if the pass declares no views or the device has no descriptor tables
+		rhi::DescriptorTable* GetDescriptorTable() const
 		{
-			return framegraph_.GetFrameGraphResource(handle).GetDesc();
+			return framegraph_.GetDescriptorTable(pass_node_.id);
 		}
+
+		// index of the view of a read or written handle in the table, ~0u if it has none
+		uint32_t GetDescriptorIndex(FrameGraphHandle handle) const;
+
+		// id of the template instance the pass belongs to, ~0u for passes added directly
+		uint32_t GetInstance() const { return pass_node_.instance; }
 	private:
+		FrameGraphHandle MapHandle(FrameGraphHandle handle) const
+		{
+			return pass_node_.handle_map ? pass_node_.handle_map[handle] : handle;
+		}
+
 		FrameGraph& framegraph_;
 		PassNode& pass_node_;
 	};
-}
-
+}
\ No newline at end of file
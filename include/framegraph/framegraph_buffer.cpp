@@ -0,0 +1,51 @@
+#include "framegraph_buffer.h"
+
+#include "framegraph_resource.h"
+
+namespace light::fg
+{
+	void FrameGraphBuffer::Create(const Desc& desc, FrameGraphResourcePool& pool)
+	{
+		buffer = pool.AcquireBuffer(desc);
+
+		// the frame graph plans every transition of it, the command lists skip the state tracking.
+		// cpu visible buffers stay in the state of their heap
+		if (buffer && desc.cpu_access == rhi::CpuAccess::kNone)
+		{
+			buffer->SetPermanentState(true);
+		}
+	}
+
+	void FrameGraphBuffer::Destroy(const Desc&, FrameGraphResourcePool& pool)
+	{
+		// the passes of this frame may still be recorded with it
+		pool.ReleaseBuffer(buffer);
+	}
+
+	bool FrameGraphBuffer::FillBarrier(rhi::ResourceBarrier& barrier)
+	{
+		barrier.buffer = buffer.Get();
+		return buffer != nullptr;
+	}
+
+	size_t FrameGraphBuffer::Hash(const Desc& desc)
+	{
+		return FrameGraphResourcePool::Hash(desc);
+	}
+
+	bool FrameGraphBuffer::IsCompatible(const Desc& lhs, const Desc& rhs)
+	{
+		return FrameGraphResourcePool::IsCompatible(lhs, rhs);
+	}
+
+	uint64_t FrameGraphBuffer::GetMemorySize(const Desc& desc)
+	{
+		return rhi::Align<uint64_t>(desc.size_in_bytes, kDefaultPlacementAlignment);
+	}
+
+	std::string FrameGraphBuffer::ToString(const Desc& desc)
+	{
+		return std::to_string(desc.size_in_bytes) + " bytes stride " + std::to_string(desc.stride)
+			+ (desc.is_uav ? " uav" : "");
+	}
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+#include "framegraph_resource_pool.h"
+
+#include "rhi/buffer.h"
+#include "rhi/command_list.h"
+
+namespace light::fg
+{
+	// Buffer of the frame graph, transient ones come from the resource pool of the graph
+	struct FrameGraphBuffer
+	{
+		using Desc = rhi::BufferDesc;
+
+		void Create(const Desc& desc, FrameGraphResourcePool& pool);
+		void Destroy(const Desc& desc, FrameGraphResourcePool& pool);
+
+		bool FillBarrier(rhi::ResourceBarrier& barrier);
+
+		static size_t Hash(const Desc& desc);
+		static bool IsCompatible(const Desc& lhs, const Desc& rhs);
+
+		// size with the placement alignment, independent of the backend
+		static uint64_t GetMemorySize(const Desc& desc);
+		static std::string ToString(const Desc& desc);
+
+		rhi::BufferHandle buffer;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "framegraph.h"
+
+namespace light::fg
+{
+	namespace
+	{
+		const char* GetQueueName(rhi::CommandListType queue)
+		{
+			switch (queue)
+			{
+			case rhi::CommandListType::kCompute:
+				return "compute";
+			case rhi::CommandListType::kCopy:
+				return "copy";
+			default:
+				return "direct";
+			}
+		}
+
+		// escapes for both dot and json string literals
+		void AppendEscaped(std::string& out, std::string_view str)
+		{
+			for (auto c : str)
+			{
+				switch (c)
+				{
+				case '"':
+					out += "\\\"";
+					break;
+				case '\\':
+					out += "\\\\";
+					break;
+				case '\n':
+					out += "\\n";
+					break;
+				default:
+					out += c;
+					break;
+				}
+			}
+		}
+
+		std::string FormatMicroseconds(uint64_t ns)
+		{
+			auto us = std::to_string(ns / 1000);
+			auto fraction = std::to_string(ns % 1000 / 100);
+			return us + "." + fraction + "us";
+		}
+	}
+
+	std::string FrameGraph::ExportGraphviz() const
+	{
+		std::vector<uint32_t> positions(pass_nodes_.size(), ~0u);
+		for (uint32_t position = 0; position < execution_order_.size(); ++position)
+		{
+			positions[execution_order_[position]] = position;
+		}
+
+		std::string out = "digraph framegraph\n{\n\trankdir=LR;\n\tnode [fontname=\"Consolas\", fontsize=10];\n\n";
+
+		for (auto& pass_node : pass_nodes_)
+		{
+			const auto& stats = pass_stats_[pass_node.id];
+
+			out += "\tpass_" + std::to_string(pass_node.id) + " [shape=box, label=\"";
+			AppendEscaped(out, pass_node.name);
+			out += "\\n" + std::string(GetQueueName(pass_node.queue));
+
+			if (pass_node.CanExecute())
+			{
+				out += " #" + std::to_string(positions[pass_node.id]);
+				if (pass_render_passes_[pass_node.id] != kInvalidRenderPass)
+				{
+					out += " render pass " + std::to_string(pass_render_passes_[pass_node.id]);
+				}
+				out += "\\nsetup " + FormatMicroseconds(stats.setup_ns) + " execute " + FormatMicroseconds(stats.execute_ns);
+				out += "\\ncreates " + std::to_string(stats.num_created) + " reuses " + std::to_string(stats.num_reused);
+				out += "\", style=filled, fillcolor=orange];\n";
+			}
+			else
+			{
+				out += " culled\", style=dashed, color=gray, fontcolor=gray];\n";
+			}
+		}
+
+		out += "\n";
+
+		auto append_resource_node = [&](const ResourceNode& resource_node, const char* indent)
+		{
+			const auto& resource = resources_[resource_node.rid];
+
+			out += indent;
+			out += "resource_" + std::to_string(resource_node.id) + " [shape=ellipse, label=\"";
+			AppendEscaped(out, resource_node.name);
+			out += " v" + std::to_string(resource_node.version);
+
+			auto desc = resource.ToString();
+			if (!desc.empty())
+			{
+				out += "\\n";
+				AppendEscaped(out, desc);
+			}
+
+			if (resource.producer && resource.last)
+			{
+				out += "\\nlifetime [" + std::to_string(positions[resource.producer->id]) + ", " + std::to_string(positions[resource.last->id]) + "]";
+			}
+
+			out += resource.IsImported() ? "\", style=filled, fillcolor=lightyellow];\n" : "\", style=filled, fillcolor=skyblue];\n";
+		};
+
+		for (auto& resource_node : resource_nodes_)
+		{
+			append_resource_node(resource_node, "\t");
+		}
+
+		out += "\n";
+
+		for (auto& pass_node : pass_nodes_)
+		{
+			auto pass = "pass_" + std::to_string(pass_node.id);
+
+			for (auto handle : pass_node.reads)
+			{
+				out += "\tresource_" + std::to_string(handle) + " -> " + pass + " [color=olivedrab];\n";
+			}
+
+			for (auto handle : pass_node.writes)
+			{
+				out += "\t" + pass + " -> resource_" + std::to_string(handle) + " [color=orangered];\n";
+			}
+		}
+
+		out += "}\n";
+
+		return out;
+	}
+
+	std::string FrameGraph::ExportJson() const
+	{
+		std::vector<uint32_t> positions(pass_nodes_.size(), ~0u);
+		for (uint32_t position = 0; position < execution_order_.size(); ++position)
+		{
+			positions[execution_order_[position]] = position;
+		}
+
+		auto append_handles = [](std::string& out, const FrameArenaVector<FrameGraphHandle>& handles)
+		{
+			out += "[";
+			for (size_t i = 0; i < handles.size(); ++i)
+			{
+				out += (i ? ", " : "") + std::to_string(handles[i]);
+			}
+			out += "]";
+		};
+
+		std::string out = "{\n\t\"passes\": [";
+
+		for (auto& pass_node : pass_nodes_)
+		{
+			const auto& stats = pass_stats_[pass_node.id];
+
+			out += pass_node.id ? ",\n\t\t{ " : "\n\t\t{ ";
+			out += "\"id\": " + std::to_string(pass_node.id);
+			out += ", \"name\": \"";
+			AppendEscaped(out, pass_node.name);
+			out += "\", \"queue\": \"" + std::string(GetQueueName(pass_node.queue)) + "\"";
+			out += ", \"culled\": " + std::string(pass_node.CanExecute() ? "false" : "true");
+			out += ", \"position\": " + (pass_node.CanExecute() ? std::to_string(positions[pass_node.id]) : std::string("null"));
+			out += ", \"render_pass\": " + (pass_render_passes_[pass_node.id] != kInvalidRenderPass ? std::to_string(pass_render_passes_[pass_node.id]) : std::string("null"));
+			out += ", \"setup_ns\": " + std::to_string(stats.setup_ns);
+			out += ", \"execute_ns\": " + std::to_string(stats.execute_ns);
+			out += ", \"created\": " + std::to_string(stats.num_created);
+			out += ", \"reused\": " + std::to_string(stats.num_reused);
+			out += ", \"reads\": ";
+			append_handles(out, pass_node.reads);
+			out += ", \"writes\": ";
+			append_handles(out, pass_node.writes);
+			out += " }";
+		}
+
+		out += "\n\t],\n\t\"resources\": [";
+
+		for (auto& resource_node : resource_nodes_)
+		{
+			const auto& resource = resources_[resource_node.rid];
+
+			out += resource_node.id ? ",\n\t\t{ " : "\n\t\t{ ";
+			out += "\"id\": " + std::to_string(resource_node.id);
+			out += ", \"rid\": " + std::to_string(resource_node.rid);
+			out += ", \"version\": " + std::to_string(resource_node.version);
+			out += ", \"name\": \"";
+			AppendEscaped(out, resource_node.name);
+			out += "\", \"desc\": \"";
+			AppendEscaped(out, resource.ToString());
+			out += "\", \"imported\": " + std::string(resource.IsImported() ? "true" : "false");
+
+			if (resource.producer && resource.last)
+			{
+				out += ", \"lifetime\": [" + std::to_string(positions[resource.producer->id]) + ", " + std::to_string(positions[resource.last->id]) + "]";
+			}
+			else
+			{
+				out += ", \"lifetime\": null";
+			}
+
+			if (resource.GetMemorySize() > 0)
+			{
+				out += ", \"size\": " + std::to_string(resource.GetMemorySize());
+			}
+
+			out += " }";
+		}
+
+		out += "\n\t],\n\t\"memory\": { ";
+		out += "\"peak_bytes\": " + std::to_string(memory_estimate_.peak_bytes);
+		out += ", \"serialized_passes\": " + std::to_string(memory_estimate_.num_serialized_passes);
+		out += " },\n\t\"schedule\": { ";
+
+		auto append_order = [](std::string& out, const std::vector<uint32_t>& order)
+		{
+			out += "[";
+			for (size_t i = 0; i < order.size(); ++i)
+			{
+				out += (i ? ", " : "") + std::to_string(order[i]);
+			}
+			out += "]";
+		};
+
+		out += "\"declaration_order\": ";
+		append_order(out, schedule_stats_.declaration_order);
+		out += ", \"execution_order\": ";
+		append_order(out, execution_order_);
+		out += ", \"declaration_barriers\": " + std::to_string(schedule_stats_.num_declaration_barriers);
+		out += ", \"scheduled_barriers\": " + std::to_string(schedule_stats_.num_scheduled_barriers);
+		out += " }\n}\n";
+
+		return out;
+	}
+}
\ No newline at end of file
@@ -2,14 +2,14 @@
 
 namespace light::fg
 {
-	void FrameGraphResource::Create()
+	void FrameGraphResource::Create(FrameGraphResourcePool& pool)
 	{
-		concept_model->Create();
+		concept_model->Create(pool);
 	}
 
-	void FrameGraphResource::Destroy()
+	void FrameGraphResource::Destroy(FrameGraphResourcePool& pool)
 	{
-		concept_model->Destroy();
+		concept_model->Destroy(pool);
 	}
 
 
@@ -1,53 +1,326 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <type_traits>
+
+#include "framegraph_resource_pool.h"
+#include "frame_arena.h"
+
+#include "rhi/command_list.h"
 
 namespace light::fg
 {
 	struct PassNode;
 
+	// placement alignment of buffers and non msaa textures on d3d12 and vulkan, the memory sizes are rounded up to it
+	constexpr uint64_t kDefaultPlacementAlignment = 64 * 1024;
+
+	// Mips and array slices of a resource, buffers have one subresource
+	struct FrameGraphSubresources
+	{
+		uint32_t num_mips = 1;
+		uint32_t num_slices = 1;
+	};
+
+	// Mips [first_mip, first_mip + num_mips) of the array slices [first_slice, first_slice + num_slices),
+	// kAll counts run to the last mip or slice of the resource
+	struct FrameGraphSubresourceRange
+	{
+		static constexpr uint32_t kAll = ~0u;
+
+		uint32_t first_mip = 0;
+		uint32_t num_mips = kAll;
+		uint32_t first_slice = 0;
+		uint32_t num_slices = kAll;
+
+		static FrameGraphSubresourceRange Mip(uint32_t mip) { return { mip, 1, 0, kAll }; }
+		static FrameGraphSubresourceRange Slice(uint32_t slice) { return { 0, kAll, slice, 1 }; }
+
+		// clamps the kAll counts to the subresources of a resource
+		FrameGraphSubresourceRange Resolve(const FrameGraphSubresources& subresources) const
+		{
+			FrameGraphSubresourceRange range = *this;
+			range.num_mips = std::min(num_mips, subresources.num_mips - std::min(first_mip, subresources.num_mips));
+			range.num_slices = std::min(num_slices, subresources.num_slices - std::min(first_slice, subresources.num_slices));
+			return range;
+		}
+
+		bool IsWhole(const FrameGraphSubresources& subresources) const
+		{
+			auto range = Resolve(subresources);
+			return first_mip == 0 && first_slice == 0 && range.num_mips == subresources.num_mips && range.num_slices == subresources.num_slices;
+		}
+
+		// kAll counts reach past every subresource, so neither needs the resource
+		bool Overlaps(const FrameGraphSubresourceRange& other) const
+		{
+			return first_mip < End(other.first_mip, other.num_mips) && other.first_mip < End(first_mip, num_mips)
+				&& first_slice < End(other.first_slice, other.num_slices) && other.first_slice < End(first_slice, num_slices);
+		}
+
+		bool Contains(const FrameGraphSubresourceRange& other) const
+		{
+			return first_mip <= other.first_mip && End(other.first_mip, other.num_mips) <= End(first_mip, num_mips)
+				&& first_slice <= other.first_slice && End(other.first_slice, other.num_slices) <= End(first_slice, num_slices);
+		}
+
+		// only valid if the ranges overlap
+		FrameGraphSubresourceRange Intersect(const FrameGraphSubresourceRange& other) const
+		{
+			FrameGraphSubresourceRange range;
+			range.first_mip = std::max(first_mip, other.first_mip);
+			range.num_mips = Count(range.first_mip, std::min(End(first_mip, num_mips), End(other.first_mip, other.num_mips)));
+			range.first_slice = std::max(first_slice, other.first_slice);
+			range.num_slices = Count(range.first_slice, std::min(End(first_slice, num_slices), End(other.first_slice, other.num_slices)));
+			return range;
+		}
+
+		bool operator==(const FrameGraphSubresourceRange& other) const
+		{
+			return first_mip == other.first_mip && num_mips == other.num_mips
+				&& first_slice == other.first_slice && num_slices == other.num_slices;
+		}
+
+		bool operator!=(const FrameGraphSubresourceRange& other) const { return !(*this == other); }
+	private:
+		static uint64_t End(uint32_t first, uint32_t count)
+		{
+			return count == kAll ? UINT64_MAX : uint64_t(first) + count;
+		}
+
+		static uint32_t Count(uint32_t first, uint64_t end)
+		{
+			return end == UINT64_MAX ? kAll : static_cast<uint32_t>(end - first);
+		}
+	};
+
+	namespace detail
+	{
+		// optional hooks of a resource type T:
+		//	static uint64_t GetMemorySize(const T::Desc&), bytes counted against the memory budget
+		//	void Create(const T::Desc&, FrameGraphResourcePool&) and void Destroy(const T::Desc&, FrameGraphResourcePool&),
+		//		with Hash and IsCompatible a later resource of the same desc may take the object over before the passes are recorded,
+		//		Destroy gives it back to the pool and keeps it usable until the resource goes away with the graph
+		//	static std::string ToString(const T::Desc&)
+		//	static size_t Hash(const T::Desc&), lets a desc change invalidate the compiled graph cache
+		//	static bool IsCompatible(const T::Desc&, const T::Desc&), whether the object of one desc serves the other
+		//	bool FillBarrier(rhi::ResourceBarrier&), sets the rhi resource of a planned barrier
+		//	static FrameGraphSubresources GetSubresources(const T::Desc&), lets passes use mips and slices separately
+		template<typename T, typename = void>
+		struct HasMemorySize : std::false_type {};
+
+		template<typename T>
+		struct HasMemorySize<T, std::void_t<decltype(T::GetMemorySize(std::declval<const typename T::Desc&>()))>>
+			: std::true_type {};
+
+		template<typename T, typename = void>
+		struct HasPooledCreate : std::false_type {};
+
+		template<typename T>
+		struct HasPooledCreate<T, std::void_t<decltype(std::declval<T&>().Create(
+			std::declval<const typename T::Desc&>(), std::declval<FrameGraphResourcePool&>()))>>
+			: std::true_type {};
+
+		template<typename T, typename = void>
+		struct HasToString : std::false_type {};
+
+		template<typename T>
+		struct HasToString<T, std::void_t<decltype(T::ToString(std::declval<const typename T::Desc&>()))>>
+			: std::true_type {};
+
+		template<typename T, typename = void>
+		struct HasFillBarrier : std::false_type {};
+
+		template<typename T>
+		struct HasFillBarrier<T, std::void_t<decltype(std::declval<T&>().FillBarrier(std::declval<rhi::ResourceBarrier&>()))>>
+			: std::true_type {};
+
+		template<typename T, typename = void>
+		struct HasSubresources : std::false_type {};
+
+		template<typename T>
+		struct HasSubresources<T, std::void_t<decltype(T::GetSubresources(std::declval<const typename T::Desc&>()))>>
+			: std::true_type {};
+
+		template<typename T, typename = void>
+		struct HasDescHash : std::false_type {};
+
+		template<typename T>
+		struct HasDescHash<T, std::void_t<decltype(T::Hash(std::declval<const typename T::Desc&>()))>>
+			: std::true_type {};
+
+		template<typename T, typename = void>
+		struct HasDescCompatible : std::false_type {};
+
+		template<typename T>
+		struct HasDescCompatible<T, std::void_t<decltype(T::IsCompatible(
+			std::declval<const typename T::Desc&>(), std::declval<const typename T::Desc&>()))>>
+			: std::true_type {};
+	}
+
 	struct FrameGraphResource
 	{
 		struct Concept
 		{
 			virtual ~Concept() = default;
 
-			virtual void Create() = 0;
-			virtual void Destroy() = 0;
+			virtual void Create(FrameGraphResourcePool& pool) = 0;
+			virtual void Destroy(FrameGraphResourcePool& pool) = 0;
+
+			virtual uint64_t GetMemorySize() const = 0;
+
+			virtual bool FillBarrier(rhi::ResourceBarrier& barrier) = 0;
+
+			virtual size_t GetDescHash() const = 0;
+
+			// pooled by its desc hash, another resource of the same desc can take the object over
+			virtual bool IsPooled() const = 0;
+
+			// the desc of other is served by the object of this one, false for other resource types
+			virtual bool IsCompatible(const Concept& other) const = 0;
+
+			virtual FrameGraphSubresources GetSubresources() const = 0;
 
 			virtual std::string ToString() = 0;
+
+			// copy of the desc and the resource, used by template instances
+			virtual Concept* Clone(FrameArena& arena) const = 0;
 		};
 
 		template<typename T>
 		struct Model : public Concept
 		{
 			Model(typename T::Desc&& desc, T&& resource)
-				: desc(std::forward(desc))
-				, resource(std::forward(resource))
+				: desc(std::move(desc))
+				, resource(std::move(resource))
+			{
+
+			}
+
+			void Create(FrameGraphResourcePool& pool) override
+			{
+				if constexpr (detail::HasPooledCreate<T>::value)
+				{
+					resource.Create(desc, pool);
+				}
+				else
+				{
+					resource.Create(desc);
+				}
+			}
+
+			void Destroy(FrameGraphResourcePool& pool) override
+			{
+				if constexpr (detail::HasPooledCreate<T>::value)
+				{
+					resource.Destroy(desc, pool);
+				}
+				else
+				{
+					resource.Destroy(desc);
+				}
+			}
+
+			uint64_t GetMemorySize() const override
+			{
+				if constexpr (detail::HasMemorySize<T>::value)
+				{
+					return T::GetMemorySize(desc);
+				}
+				else
+				{
+					return 0;
+				}
+			}
+
+			bool FillBarrier(rhi::ResourceBarrier& barrier) override
+			{
+				if constexpr (detail::HasFillBarrier<T>::value)
+				{
+					return resource.FillBarrier(barrier);
+				}
+				else
+				{
+					return false;
+				}
+			}
+
+			size_t GetDescHash() const override
+			{
+				if constexpr (detail::HasDescHash<T>::value)
+				{
+					return T::Hash(desc);
+				}
+				else
+				{
+					return 0;
+				}
+			}
+
+			bool IsPooled() const override
+			{
+				return detail::HasPooledCreate<T>::value && detail::HasDescHash<T>::value && detail::HasDescCompatible<T>::value;
+			}
+
+			bool IsCompatible(const Concept& other) const override
 			{
+				if constexpr (detail::HasDescCompatible<T>::value)
+				{
+					auto* model = dynamic_cast<const Model<T>*>(&other);
+					return model && T::IsCompatible(desc, model->desc);
+				}
+				else
+				{
+					return false;
+				}
+			}
 
+			FrameGraphSubresources GetSubresources() const override
+			{
+				if constexpr (detail::HasSubresources<T>::value)
+				{
+					return T::GetSubresources(desc);
+				}
+				else
+				{
+					return {};
+				}
 			}
 
-			void Create() override
+			std::string ToString() override
 			{
-				resource.Create(desc);
+				if constexpr (detail::HasToString<T>::value)
+				{
+					return T::ToString(desc);
+				}
+				else
+				{
+					return {};
+				}
 			}
 
-			void Destroy() override
+			Concept* Clone(FrameArena& arena) const override
 			{
-				resource.Destroy(desc);
+				if constexpr (std::is_copy_constructible_v<typename T::Desc> && std::is_copy_constructible_v<T>)
+				{
+					return arena.New<Model<T>>(typename T::Desc(desc), T(resource));
+				}
+				else
+				{
+					return nullptr;
+				}
 			}
 
-			typename const T::Desc desc;
+			const typename T::Desc desc;
 			T resource;
 		};
 
-		template<typename T>
-		FrameGraphResource(uint32_t id, typename T::Desc&& desc, T&& resource, uint32_t version, bool imported = false)
+		FrameGraphResource(uint32_t id, Concept* concept_model, uint32_t version, bool imported = false)
 			: id(id)
-			, concept_model(std::make_unique<Model<T>>(std::forward(desc), std::forward(resource)))
+			, concept_model(concept_model)
 			, version(version)
 			, imported(imported)
 			, producer(nullptr)
@@ -56,10 +329,25 @@ namespace light::fg
 
 		}
 
-		void Create();
-		void Destroy();
+		void Create(FrameGraphResourcePool& pool);
+		void Destroy(FrameGraphResourcePool& pool);
 
 		bool IsImported() const { return imported; }
+
+		// size of the allocation of its object
+		uint64_t GetMemorySize() const { return concept_model->GetMemorySize(); }
+
+		bool FillBarrier(rhi::ResourceBarrier& barrier) { return concept_model->FillBarrier(barrier); }
+
+		size_t GetDescHash() const { return concept_model->GetDescHash(); }
+
+		bool IsPooled() const { return concept_model->IsPooled(); }
+
+		bool IsCompatible(const FrameGraphResource& other) const { return concept_model->IsCompatible(*other.concept_model); }
+
+		FrameGraphSubresources GetSubresources() const { return concept_model->GetSubresources(); }
+
+		std::string ToString() const { return concept_model->ToString(); }
 	
 		template<typename T>
 		T& Get()
@@ -68,7 +356,7 @@ namespace light::fg
 		}
 
 		template<typename T>
-		typename T::Desc& GetDesc()
+		const typename T::Desc& GetDesc()
 		{
 			return GetModel<T>()->desc;
 		}
@@ -76,11 +364,11 @@ namespace light::fg
 		template<typename T>
 		auto* GetModel()
 		{
-			return static_cast<Model<T>*>(concept_model.get());
+			return static_cast<Model<T>*>(concept_model);
 		}
 
 		const uint32_t id;
-		std::unique_ptr<Concept> concept_model;
+		Concept* concept_model;	// lives in the FrameArena of the graph
 		uint32_t version;		// ÿһǵ
 		const bool imported;	// ǷǵԴ
 
@@ -0,0 +1,184 @@
+#include "framegraph_resource_pool.h"
+
+namespace light::fg
+{
+	FrameGraphResourcePool::FrameGraphResourcePool(uint32_t max_unused_frames)
+		: device_(nullptr)
+		, max_unused_frames_(max_unused_frames)
+		, frame_(0)
+	{
+	}
+
+	void FrameGraphResourcePool::SetDevice(rhi::Device* device)
+	{
+		if (device_ != device)
+		{
+			Clear();
+			device_ = device;
+		}
+	}
+
+	rhi::TextureHandle FrameGraphResourcePool::AcquireTexture(const rhi::TextureDesc& desc)
+	{
+		auto texture = Acquire(textures_, desc);
+		if (texture)
+		{
+			--stats_.num_free_textures;
+			return texture;
+		}
+
+		++stats_.misses;
+		return device_ ? device_->CreateTexture(desc) : nullptr;
+	}
+
+	void FrameGraphResourcePool::ReleaseTexture(rhi::TextureHandle texture)
+	{
+		if (texture)
+		{
+			auto hash = Hash(texture->GetDesc());
+			textures_[hash].push_back({ std::move(texture), frame_ });
+			++stats_.num_free_textures;
+		}
+	}
+
+	rhi::BufferHandle FrameGraphResourcePool::AcquireBuffer(const rhi::BufferDesc& desc)
+	{
+		auto buffer = Acquire(buffers_, desc);
+		if (buffer)
+		{
+			--stats_.num_free_buffers;
+			return buffer;
+		}
+
+		++stats_.misses;
+		return device_ ? device_->CreateBuffer(desc) : nullptr;
+	}
+
+	void FrameGraphResourcePool::ReleaseBuffer(rhi::BufferHandle buffer)
+	{
+		if (buffer)
+		{
+			auto hash = Hash(buffer->GetDesc());
+			buffers_[hash].push_back({ std::move(buffer), frame_ });
+			++stats_.num_free_buffers;
+		}
+	}
+
+	void FrameGraphResourcePool::Tick()
+	{
+		++frame_;
+
+		Evict(textures_, stats_.num_free_textures);
+		Evict(buffers_, stats_.num_free_buffers);
+	}
+
+	void FrameGraphResourcePool::Clear()
+	{
+		textures_.clear();
+		buffers_.clear();
+
+		stats_.num_free_textures = 0;
+		stats_.num_free_buffers = 0;
+	}
+
+	size_t FrameGraphResourcePool::Hash(const rhi::TextureDesc& desc)
+	{
+		size_t hash = 0;
+		rhi::HashCombine(hash, desc.width);
+		rhi::HashCombine(hash, desc.height);
+		rhi::HashCombine(hash, desc.depth);
+		rhi::HashCombine(hash, desc.array_size);
+		rhi::HashCombine(hash, desc.mip_levels);
+		rhi::HashCombine(hash, static_cast<uint32_t>(desc.format));
+		rhi::HashCombine(hash, static_cast<uint32_t>(desc.dimension));
+		return hash;
+	}
+
+	size_t FrameGraphResourcePool::Hash(const rhi::BufferDesc& desc)
+	{
+		size_t hash = 0;
+		rhi::HashCombine(hash, static_cast<uint32_t>(desc.type));
+		rhi::HashCombine(hash, static_cast<uint32_t>(desc.cpu_access));
+		rhi::HashCombine(hash, static_cast<uint32_t>(desc.format));
+		rhi::HashCombine(hash, desc.is_uav);
+		rhi::HashCombine(hash, desc.stride);
+		rhi::HashCombine(hash, desc.size_in_bytes);
+		return hash;
+	}
+
+	bool FrameGraphResourcePool::IsCompatible(const rhi::TextureDesc& lhs, const rhi::TextureDesc& rhs)
+	{
+		return lhs.width == rhs.width
+			&& lhs.height == rhs.height
+			&& lhs.depth == rhs.depth
+			&& lhs.array_size == rhs.array_size
+			&& lhs.mip_levels == rhs.mip_levels
+			&& lhs.format == rhs.format
+			&& lhs.dimension == rhs.dimension;
+	}
+
+	bool FrameGraphResourcePool::IsCompatible(const rhi::BufferDesc& lhs, const rhi::BufferDesc& rhs)
+	{
+		return lhs.type == rhs.type
+			&& lhs.cpu_access == rhs.cpu_access
+			&& lhs.format == rhs.format
+			&& lhs.is_uav == rhs.is_uav
+			&& lhs.stride == rhs.stride
+			&& lhs.size_in_bytes == rhs.size_in_bytes;
+	}
+
+	template<typename Handle, typename Desc>
+	Handle FrameGraphResourcePool::Acquire(Buckets<Handle>& buckets, const Desc& desc)
+	{
+		auto it = buckets.find(Hash(desc));
+		if (it == buckets.end())
+		{
+			return nullptr;
+		}
+
+		auto& entries = it->second;
+		for (size_t i = entries.size(); i-- > 0;)
+		{
+			if (IsCompatible(entries[i].handle->GetDesc(), desc))
+			{
+				Handle handle = std::move(entries[i].handle);
+				if (i + 1 != entries.size())
+				{
+					entries[i] = std::move(entries.back());
+				}
+				entries.pop_back();
+				++stats_.hits;
+				return handle;
+			}
+		}
+
+		return nullptr;
+	}
+
+	template<typename Handle>
+	void FrameGraphResourcePool::Evict(Buckets<Handle>& buckets, uint32_t& num_free)
+	{
+		// empty buckets are kept, their storage is reused by the next release
+		for (auto& bucket : buckets)
+		{
+			auto& entries = bucket.second;
+			for (size_t i = 0; i < entries.size();)
+			{
+				if (frame_ - entries[i].last_used_frame > max_unused_frames_)
+				{
+					if (i + 1 != entries.size())
+					{
+						entries[i] = std::move(entries.back());
+					}
+					entries.pop_back();
+					--num_free;
+					++stats_.evictions;
+				}
+				else
+				{
+					++i;
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
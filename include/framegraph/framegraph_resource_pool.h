@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "rhi/device.h"
+
+namespace light::fg
+{
+	struct FrameGraphResourcePoolStats
+	{
+		uint64_t hits = 0;			// acquires served by a pooled object
+		uint64_t misses = 0;		// acquires that created a new gpu object
+		uint64_t evictions = 0;		// pooled objects dropped after max_unused_frames
+		uint32_t num_free_textures = 0;
+		uint32_t num_free_buffers = 0;
+	};
+
+	// Keeps the textures and buffers of transient frame graph resources alive across frames,
+	// an object released in one frame is handed out again for the same desc in the next one.
+	class FrameGraphResourcePool
+	{
+	public:
+		explicit FrameGraphResourcePool(uint32_t max_unused_frames = 3);
+
+		// switching to another device drops every pooled object
+		void SetDevice(rhi::Device* device);
+
+		rhi::Device* GetDevice() const { return device_; }
+
+		rhi::TextureHandle AcquireTexture(const rhi::TextureDesc& desc);
+		void ReleaseTexture(rhi::TextureHandle texture);
+
+		rhi::BufferHandle AcquireBuffer(const rhi::BufferDesc& desc);
+		void ReleaseBuffer(rhi::BufferHandle buffer);
+
+		// ends a frame, drops the objects unused for more than max_unused_frames frames
+		void Tick();
+
+		void Clear();
+
+		void SetMaxUnusedFrames(uint32_t max_unused_frames) { max_unused_frames_ = max_unused_frames; }
+
+		const FrameGraphResourcePoolStats& GetStats() const { return stats_; }
+
+		static size_t Hash(const rhi::TextureDesc& desc);
+		static size_t Hash(const rhi::BufferDesc& desc);
+
+		// debug names are ignored, they don't change the gpu object
+		static bool IsCompatible(const rhi::TextureDesc& lhs, const rhi::TextureDesc& rhs);
+		static bool IsCompatible(const rhi::BufferDesc& lhs, const rhi::BufferDesc& rhs);
+	private:
+		template<typename Handle>
+		struct Entry
+		{
+			Handle handle;
+			uint64_t last_used_frame;
+		};
+
+		template<typename Handle>
+		using Buckets = std::unordered_map<size_t, std::vector<Entry<Handle>>>;
+
+		template<typename Handle, typename Desc>
+		Handle Acquire(Buckets<Handle>& buckets, const Desc& desc);
+
+		template<typename Handle>
+		void Evict(Buckets<Handle>& buckets, uint32_t& num_free);
+
+		rhi::Device* device_;
+		uint32_t max_unused_frames_;
+		uint64_t frame_;
+
+		Buckets<rhi::TextureHandle> textures_;
+		Buckets<rhi::BufferHandle> buffers_;
+
+		FrameGraphResourcePoolStats stats_;
+	};
+}
\ No newline at end of file
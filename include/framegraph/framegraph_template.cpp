@@ -0,0 +1,115 @@
+#include "framegraph_template.h"
+
+namespace light::fg
+{
+	FrameGraphHandle FrameGraphTemplate::AddParameter(std::string_view name)
+	{
+		CHECK(graph_.pass_nodes_.empty(), "template parameters have to be added before the passes");
+
+		++num_parameters_;
+		return graph_.CreateFrameGraphResource<FrameGraphTemplateParameter>(name, {}, {});
+	}
+
+	FrameGraphInstance FrameGraph::Instantiate(const FrameGraphTemplate& subgraph, const FrameGraphHandle* parameters, uint32_t num_parameters)
+	{
+		const auto& graph = subgraph.graph_;
+		CHECK(num_parameters == subgraph.num_parameters_, "every parameter of the template has to be bound");
+
+		// template rid -> rid, parameters are the first resources of the template
+		auto* rids = static_cast<uint32_t*>(arena_.Allocate(sizeof(uint32_t) * graph.resources_.size(), alignof(uint32_t)));
+		for (const auto& resource : graph.resources_)
+		{
+			if (resource.id < num_parameters)
+			{
+				rids[resource.id] = resource_nodes_[parameters[resource.id]].rid;
+				continue;
+			}
+
+			auto* model = resource.concept_model->Clone(arena_);
+			CHECK(model, "template resources need a copyable desc and resource");
+
+			rids[resource.id] = static_cast<uint32_t>(resources_.size());
+			resources_.emplace_back(rids[resource.id], model, resource.version, resource.IsImported());
+		}
+
+		// nodes keep their template order, so the versions of a bound resource continue in the order the template wrote them
+		auto* handles = static_cast<FrameGraphHandle*>(arena_.Allocate(sizeof(FrameGraphHandle) * graph.resource_nodes_.size(), alignof(FrameGraphHandle)));
+		for (const auto& node : graph.resource_nodes_)
+		{
+			if (node.rid >= num_parameters)
+			{
+				handles[node.id] = CreateResourceNode(node.name, rids[node.rid], node.version, node.range).id;
+			}
+			else if (node.version == 0)
+			{
+				handles[node.id] = parameters[node.rid];
+				continue;
+			}
+			else
+			{
+				auto& resource = resources_[rids[node.rid]];
+				handles[node.id] = CreateResourceNode(node.name, resource.id, ++resource.version, node.range).id;
+			}
+
+			if (node.previous != ~0u)
+			{
+				resource_nodes_[handles[node.id]].previous = handles[node.previous];
+			}
+		}
+
+		uint32_t instance = num_instances_++;
+		for (const auto& pass : graph.pass_nodes_)
+		{
+			uint32_t id = pass_nodes_.size();
+			auto& pass_node = pass_nodes_.emplace_back(pass.name, id, pass.queue, pass.execute, arena_);
+			pass_stats_.emplace_back();
+
+			pass_node.handle_map = handles;
+			pass_node.instance = instance;
+			pass_node.side_effect = pass.side_effect;
+			pass_node.readback = pass.readback;
+
+			pass_node.creates.reserve(pass.creates.size());
+			for (auto handle : pass.creates)
+			{
+				pass_node.creates.push_back(handles[handle]);
+			}
+
+			pass_node.reads.reserve(pass.reads.size());
+			for (auto handle : pass.reads)
+			{
+				pass_node.reads.push_back(handles[handle]);
+			}
+
+			pass_node.writes.reserve(pass.writes.size());
+			for (auto handle : pass.writes)
+			{
+				handle = handles[handle];
+				pass_node.writes.push_back(handle);
+
+				// the placeholders are transient, a bound imported resource keeps the pass alive like a direct write
+				if (GetFrameGraphResource(handle).IsImported())
+				{
+					pass_node.SideEffect();
+				}
+			}
+
+			pass_node.read_accesses.assign(pass.read_accesses.begin(), pass.read_accesses.end());
+			pass_node.write_accesses.assign(pass.write_accesses.begin(), pass.write_accesses.end());
+			pass_node.read_ranges.assign(pass.read_ranges.begin(), pass.read_ranges.end());
+
+			// a bound handle may cover less than the template reads of the parameter, e.g. one mip
+			for (size_t i = 0; i < pass.reads.size(); ++i)
+			{
+				const auto& node = graph.resource_nodes_[pass.reads[i]];
+				const auto& bound_node = resource_nodes_[handles[node.id]];
+				if (node.rid < num_parameters && node.version == 0 && !bound_node.range.Contains(pass.read_ranges[i]))
+				{
+					ReadVersions(pass_node, bound_node.previous, pass.read_ranges[i]);
+				}
+			}
+		}
+
+		return { instance, handles };
+	}
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "framegraph.h"
+
+namespace light::fg
+{
+	// placeholder of a template parameter, instances replace it with the resource they bind
+	struct FrameGraphTemplateParameter
+	{
+		struct Desc {};
+
+		void Create(const Desc&) {}
+		void Destroy(const Desc&) {}
+	};
+
+	// Group of passes set up once and added to a frame graph any number of times, e.g. the passes of one shadow casting light.
+	// FrameGraph::Instantiate copies the recorded nodes instead of running the setup callbacks again and binds the parameters,
+	// the passes of every instance run the execute callbacks of the template, concurrently when they land in different chunks.
+	// Instances reference the names of the template, it has to outlive the frames using it.
+	class FrameGraphTemplate
+	{
+	public:
+		FrameGraphTemplate() = default;
+		~FrameGraphTemplate() = default;
+
+		FrameGraphTemplate(const FrameGraphTemplate&) = delete;
+		FrameGraphTemplate(FrameGraphTemplate&&) = delete;
+
+		FrameGraphTemplate& operator=(const FrameGraphTemplate&) = delete;
+		FrameGraphTemplate& operator=(FrameGraphTemplate&&) = delete;
+
+		// a resource every instance binds, declared before the first pass, handles are 0, 1, ... in declaration order
+		FrameGraphHandle AddParameter(std::string_view name);
+
+		template<typename Data, typename Setup, typename Execute>
+		const Data& AddPass(std::string_view name, Setup&& setup, Execute&& execute, rhi::CommandListType queue = rhi::CommandListType::kDirect)
+		{
+			return graph_.AddPass<Data>(name, std::forward<Setup>(setup), std::forward<Execute>(execute), queue);
+		}
+
+		uint32_t GetNumParameters() const { return num_parameters_; }
+
+		uint32_t GetNumPasses() const { return static_cast<uint32_t>(graph_.pass_nodes_.size()); }
+	private:
+		friend class FrameGraph;
+
+		FrameGraph graph_;
+		uint32_t num_parameters_ = 0;
+	};
+}
\ No newline at end of file
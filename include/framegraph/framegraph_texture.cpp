@@ -0,0 +1,173 @@
+#include "framegraph_texture.h"
+
+#include <algorithm>
+
+namespace light::fg
+{
+	namespace
+	{
+		// bytes of one texel, or of one block of block_size x block_size texels for compressed formats
+		struct FormatBlock
+		{
+			uint32_t bytes;
+			uint32_t block_size;
+		};
+
+		FormatBlock GetFormatBlock(rhi::Format format)
+		{
+			using rhi::Format;
+
+			switch (format)
+			{
+			case Format::R8_UINT:
+			case Format::R8_SINT:
+			case Format::R8_UNORM:
+			case Format::R8_SNORM:
+				return { 1, 1 };
+			case Format::RG8_UINT:
+			case Format::RG8_SINT:
+			case Format::RG8_UNORM:
+			case Format::RG8_SNORM:
+			case Format::R16_UINT:
+			case Format::R16_SINT:
+			case Format::R16_UNORM:
+			case Format::R16_SNORM:
+			case Format::R16_FLOAT:
+			case Format::BGRA4_UNORM:
+			case Format::B5G6R5_UNORM:
+			case Format::B5G5R5A1_UNORM:
+			case Format::D16:
+				return { 2, 1 };
+			case Format::RGBA8_UINT:
+			case Format::RGBA8_SINT:
+			case Format::RGBA8_UNORM:
+			case Format::RGBA8_SNORM:
+			case Format::BGRA8_UNORM:
+			case Format::SRGBA8_UNORM:
+			case Format::SBGRA8_UNORM:
+			case Format::R10G10B10A2_UNORM:
+			case Format::R11G11B10_FLOAT:
+			case Format::RG16_UINT:
+			case Format::RG16_SINT:
+			case Format::RG16_UNORM:
+			case Format::RG16_SNORM:
+			case Format::RG16_FLOAT:
+			case Format::R32_UINT:
+			case Format::R32_SINT:
+			case Format::R32_FLOAT:
+			case Format::D24S8:
+			case Format::X24G8_UINT:
+			case Format::D32:
+				return { 4, 1 };
+			case Format::RGBA16_UINT:
+			case Format::RGBA16_SINT:
+			case Format::RGBA16_FLOAT:
+			case Format::RGBA16_UNORM:
+			case Format::RGBA16_SNORM:
+			case Format::RG32_UINT:
+			case Format::RG32_SINT:
+			case Format::RG32_FLOAT:
+			case Format::D32S8:
+			case Format::X32G8_UINT:
+				return { 8, 1 };
+			case Format::RGB32_UINT:
+			case Format::RGB32_SINT:
+			case Format::RGB32_FLOAT:
+				return { 12, 1 };
+			case Format::RGBA32_UINT:
+			case Format::RGBA32_SINT:
+			case Format::RGBA32_FLOAT:
+				return { 16, 1 };
+			case Format::BC1_UNORM:
+			case Format::BC1_UNORM_SRGB:
+			case Format::BC4_UNORM:
+			case Format::BC4_SNORM:
+				return { 8, 4 };
+			case Format::BC2_UNORM:
+			case Format::BC2_UNORM_SRGB:
+			case Format::BC3_UNORM:
+			case Format::BC3_UNORM_SRGB:
+			case Format::BC5_UNORM:
+			case Format::BC5_SNORM:
+			case Format::BC6H_UFLOAT:
+			case Format::BC6H_SFLOAT:
+			case Format::BC7_UNORM:
+			case Format::BC7_UNORM_SRGB:
+				return { 16, 4 };
+			default:
+				return { 0, 1 };
+			}
+		}
+	}
+
+	void FrameGraphTexture::Create(const Desc& desc, FrameGraphResourcePool& pool)
+	{
+		texture = pool.AcquireTexture(desc);
+
+		// the frame graph plans every transition of it, the command lists skip the state tracking
+		if (texture)
+		{
+			texture->SetPermanentState(true);
+		}
+	}
+
+	void FrameGraphTexture::Destroy(const Desc&, FrameGraphResourcePool& pool)
+	{
+		// the passes of this frame may still be recorded with it
+		pool.ReleaseTexture(texture);
+	}
+
+	bool FrameGraphTexture::FillBarrier(rhi::ResourceBarrier& barrier)
+	{
+		barrier.texture = texture.Get();
+		return texture != nullptr;
+	}
+
+	size_t FrameGraphTexture::Hash(const Desc& desc)
+	{
+		return FrameGraphResourcePool::Hash(desc);
+	}
+
+	bool FrameGraphTexture::IsCompatible(const Desc& lhs, const Desc& rhs)
+	{
+		return FrameGraphResourcePool::IsCompatible(lhs, rhs);
+	}
+
+	FrameGraphSubresources FrameGraphTexture::GetSubresources(const Desc& desc)
+	{
+		return { desc.mip_levels, desc.array_size };
+	}
+
+	uint64_t FrameGraphTexture::GetMemorySize(const Desc& desc)
+	{
+		auto block = GetFormatBlock(desc.format);
+		bool volume = desc.dimension == rhi::TextureDimension::kTexture3D;
+
+		uint64_t size = 0;
+		for (uint32_t mip = 0; mip < desc.mip_levels; ++mip)
+		{
+			uint64_t width = std::max(desc.width >> mip, 1u);
+			uint64_t height = std::max(desc.height >> mip, 1u);
+			uint64_t depth = volume ? std::max(desc.depth >> mip, 1u) : 1;
+
+			size += (width + block.block_size - 1) / block.block_size
+				* ((height + block.block_size - 1) / block.block_size)
+				* depth * block.bytes;
+		}
+
+		if (!volume)
+		{
+			size *= desc.array_size;
+		}
+
+		return rhi::Align(size, kDefaultPlacementAlignment);
+	}
+
+	std::string FrameGraphTexture::ToString(const Desc& desc)
+	{
+		return std::to_string(desc.width) + "x" + std::to_string(desc.height) + "x" + std::to_string(desc.depth)
+			+ " array " + std::to_string(desc.array_size)
+			+ " mips " + std::to_string(desc.mip_levels)
+			+ " format " + std::to_string(static_cast<uint32_t>(desc.format));
+	}
+}
\ No newline at end of file
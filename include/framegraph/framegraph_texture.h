@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+
+#include "framegraph_resource.h"
+#include "framegraph_resource_pool.h"
+
+#include "rhi/texture.h"
+#include "rhi/command_list.h"
+
+namespace light::fg
+{
+	// Texture of the frame graph, transient ones come from the resource pool of the graph
+	struct FrameGraphTexture
+	{
+		using Desc = rhi::TextureDesc;
+
+		void Create(const Desc& desc, FrameGraphResourcePool& pool);
+		void Destroy(const Desc& desc, FrameGraphResourcePool& pool);
+
+		bool FillBarrier(rhi::ResourceBarrier& barrier);
+
+		static size_t Hash(const Desc& desc);
+		static bool IsCompatible(const Desc& lhs, const Desc& rhs);
+		static FrameGraphSubresources GetSubresources(const Desc& desc);
+
+		// bytes of every mip and slice with the placement alignment, independent of the backend
+		static uint64_t GetMemorySize(const Desc& desc);
+		static std::string ToString(const Desc& desc);
+
+		rhi::TextureHandle texture;
+	};
+}
\ No newline at end of file
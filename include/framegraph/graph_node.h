@@ -1,7 +1,7 @@
 #pragma once
 
+#include <cstdint>
 #include <string_view>
-#include <string>
 
 namespace light::fg
 {
@@ -16,7 +16,7 @@ namespace light::fg
 		GraphNode& operator=(const GraphNode&) = delete;
 		GraphNode& operator=(GraphNode&&) = default;
 	
-		const std::string name;
+		const std::string_view name;	// owned by the FrameArena of the graph
 		const uint32_t id;
 		int32_t ref_count;
 	};
@@ -1,10 +1,82 @@
 #include "pass_node.h"
 
+#include <algorithm>
+
 namespace light::fg
 {
-	PassNode::PassNode(std::string_view name, uint32_t id, std::unique_ptr<FrameGraphPassConcept>&& execute)
+	rhi::ResourceStates ConvertAccessToResourceStates(FrameGraphAccess access)
+	{
+		rhi::ResourceStates states = rhi::ResourceStates::kCommon;
+
+		if ((access & FrameGraphAccess::kShaderResource) != 0)
+		{
+			states = states | rhi::ResourceStates::kPixelShaderResource | rhi::ResourceStates::kNonPixelShaderResource;
+		}
+
+		if ((access & FrameGraphAccess::kUnorderedAccess) != 0)
+		{
+			states = states | rhi::ResourceStates::kUnorderedAccess;
+		}
+
+		if ((access & FrameGraphAccess::kRenderTarget) != 0)
+		{
+			states = states | rhi::ResourceStates::kRenderTarget;
+		}
+
+		if ((access & FrameGraphAccess::kDepthWrite) != 0)
+		{
+			states = states | rhi::ResourceStates::kDepthWrite;
+		}
+
+		if ((access & FrameGraphAccess::kDepthRead) != 0)
+		{
+			states = states | rhi::ResourceStates::kDepthRead;
+		}
+
+		if ((access & FrameGraphAccess::kCopySource) != 0)
+		{
+			states = states | rhi::ResourceStates::kCopySource;
+		}
+
+		if ((access & FrameGraphAccess::kCopyDest) != 0)
+		{
+			states = states | rhi::ResourceStates::kCopyDest;
+		}
+
+		if ((access & FrameGraphAccess::kIndirectArgument) != 0)
+		{
+			states = states | rhi::ResourceStates::kIndirectArgument;
+		}
+
+		return states;
+	}
+
+	rhi::ResourceStates GetQueueResourceStates(rhi::CommandListType queue)
+	{
+		switch (queue)
+		{
+		case rhi::CommandListType::kCompute:
+			return rhi::ResourceStates::kVertexAndConstantBuffer | rhi::ResourceStates::kUnorderedAccess
+				| rhi::ResourceStates::kNonPixelShaderResource | rhi::ResourceStates::kIndirectArgument
+				| rhi::ResourceStates::kCopyDest | rhi::ResourceStates::kCopySource;
+		case rhi::CommandListType::kCopy:
+			return rhi::ResourceStates::kCopyDest | rhi::ResourceStates::kCopySource;
+		default:
+			return ~rhi::ResourceStates::kCommon;
+		}
+	}
+
+	PassNode::PassNode(std::string_view name, uint32_t id, rhi::CommandListType queue, FrameGraphPassConcept* execute, FrameArena& arena)
 		: GraphNode(name, id)
-		, execute(std::move(execute))
+		, creates(arena)
+		, reads(arena)
+		, writes(arena)
+		, read_accesses(arena)
+		, write_accesses(arena)
+		, read_ranges(arena)
+		, execute(execute)
+		, queue(queue)
+		, side_effect(false)
 	{
 	}
 
@@ -18,24 +90,32 @@ namespace light::fg
 
 		return creates.emplace_back(handle);
 	}
-	FrameGraphHandle PassNode::Read(FrameGraphHandle handle)
+	FrameGraphHandle PassNode::Read(FrameGraphHandle handle, FrameGraphAccess access, const FrameGraphSubresourceRange& range)
 	{
-		auto it = std::find(reads.begin(), reads.end(), handle);
-		if (it != reads.end())
+		for (size_t i = 0; i < reads.size(); ++i)
 		{
-			return *it;
+			if (reads[i] == handle && read_ranges[i] == range)
+			{
+				read_accesses[i] = read_accesses[i] | access;
+				return handle;
+			}
 		}
 
+		read_accesses.emplace_back(access);
+		read_ranges.emplace_back(range);
 		return reads.emplace_back(handle);
 	}
-	FrameGraphHandle PassNode::Write(FrameGraphHandle handle)
+	FrameGraphHandle PassNode::Write(FrameGraphHandle handle, FrameGraphAccess access)
 	{
 		auto it = std::find(writes.begin(), writes.end(), handle);
 		if (it != writes.end())
 		{
+			auto& write_access = write_accesses[it - writes.begin()];
+			write_access = write_access | access;
 			return *it;
 		}
 
+		write_accesses.emplace_back(access);
 		return writes.emplace_back(handle);
 	}
 	bool PassNode::HasCreate(FrameGraphHandle handle) const
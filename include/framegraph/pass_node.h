@@ -5,18 +5,43 @@
 
 #include "graph_node.h"
 #include "framegraph_pass.h"
+#include "framegraph_resource.h"
+#include "frame_arena.h"
+
+#include "rhi/types.h"
 
 namespace light::fg
 {
 	using FrameGraphHandle = uint32_t;
 
+	// How a pass uses a resource, drives the barriers planned by Compile
+	enum class FrameGraphAccess : uint16_t
+	{
+		kNone				= 0,
+		kShaderResource		= 0x1,
+		kUnorderedAccess	= 0x2,
+		kRenderTarget		= 0x4,
+		kDepthWrite			= 0x8,
+		kDepthRead			= 0x10,
+		kCopySource			= 0x20,
+		kCopyDest			= 0x40,
+		kIndirectArgument	= 0x80,
+	};
+
+	RHI_ENUM_CLASS_FLAG_OPERATORS(FrameGraphAccess);
+
+	rhi::ResourceStates ConvertAccessToResourceStates(FrameGraphAccess access);
+
+	// states the lists of a queue may use and transition from or to, the graphics ones only exist on the direct queue
+	rhi::ResourceStates GetQueueResourceStates(rhi::CommandListType queue);
+
 	struct PassNode final : public GraphNode
 	{
-		PassNode(std::string_view name, uint32_t id, std::unique_ptr<FrameGraphPassConcept>&& execute);
+		PassNode(std::string_view name, uint32_t id, rhi::CommandListType queue, FrameGraphPassConcept* execute, FrameArena& arena);
 
 		FrameGraphHandle Create(FrameGraphHandle handle);
-		FrameGraphHandle Read(FrameGraphHandle handle);
-		FrameGraphHandle Write(FrameGraphHandle handle);
+		FrameGraphHandle Read(FrameGraphHandle handle, FrameGraphAccess access = FrameGraphAccess::kNone, const FrameGraphSubresourceRange& range = {});
+		FrameGraphHandle Write(FrameGraphHandle handle, FrameGraphAccess access = FrameGraphAccess::kNone);
 
 		void SideEffect() { side_effect = true; }
 
@@ -25,12 +50,25 @@ namespace light::fg
 
 		bool HasCreate(FrameGraphHandle handle) const;
 
-		std::vector<FrameGraphHandle> creates;
-		std::vector<FrameGraphHandle> reads;
-		std::vector<FrameGraphHandle> writes;
+		FrameArenaVector<FrameGraphHandle> creates;
+		FrameArenaVector<FrameGraphHandle> reads;
+		FrameArenaVector<FrameGraphHandle> writes;
+
+		// parallel to reads/writes
+		FrameArenaVector<FrameGraphAccess> read_accesses;
+		FrameArenaVector<FrameGraphAccess> write_accesses;
 
-		std::unique_ptr<FrameGraphPassConcept> execute;
+		// subresources read, a handle read with two ranges has two entries, writes cover the range of their node
+		FrameArenaVector<FrameGraphSubresourceRange> read_ranges;
 
+		FrameGraphPassConcept* execute;	// lives in the FrameArena of the graph, or of the template the pass is an instance of
+
+		rhi::CommandListType queue;
 		bool side_effect;
+		bool readback = false;	// the cpu reads what the pass writes, its submission ends with it
+
+		// graph handle of every template handle, nullptr unless the pass belongs to a template instance
+		const FrameGraphHandle* handle_map = nullptr;
+		uint32_t instance = ~0u;
 	};
 }
\ No newline at end of file
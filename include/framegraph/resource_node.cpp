@@ -2,11 +2,12 @@
 
 namespace light::fg
 {
-	ResourceNode::ResourceNode(std::string_view name, uint32_t id, uint32_t rid, uint32_t version)
+	ResourceNode::ResourceNode(std::string_view name, uint32_t id, uint32_t rid, uint32_t version, const FrameGraphSubresourceRange& range)
 		: GraphNode(name, id)
 		, rid(rid)
-		, version(0)
+		, version(version)
+		, range(range)
 		, producer(nullptr)
 	{
 	}
-}
+}
\ No newline at end of file
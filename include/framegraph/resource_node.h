@@ -8,11 +8,13 @@ namespace light::fg
 	struct PassNode;
 	struct ResourceNode final : public GraphNode
 	{
-		ResourceNode(std::string_view name, uint32_t id, uint32_t rid,uint32_t version);
+		ResourceNode(std::string_view name, uint32_t id, uint32_t rid,uint32_t version, const FrameGraphSubresourceRange& range = {});
 	
 		const uint32_t rid;
 		const uint32_t version;
+		const FrameGraphSubresourceRange range;	// subresources this version covers
 
 		PassNode* producer;
+		uint32_t previous = ~0u;	// the version this one was written over, ~0u for the first one
 	};
 }
\ No newline at end of file
@@ -5,14 +5,43 @@
 #include "types.h"
 #include "resource.h"
 #include "render_target.h"
+#include "buffer.h"
 
 namespace light::rhi
 {
 	class Buffer;
 	class Texture;
 	class GraphicsPipeline;
+	class DescriptorTable;
 	class CommandQueue;
 
+	// Halves of a split transition, kBeginOnly starts it early and kEndOnly completes it right before the resource is used,
+	// the resource must not be used in between and both halves go into the same command list
+	enum class ResourceBarrierFlags : uint8_t
+	{
+		kNone,
+		kBeginOnly,
+		kEndOnly,
+	};
+
+	// Transition with a known before state, before == after == kUnorderedAccess is an uav barrier
+	struct ResourceBarrier
+	{
+		Texture* texture = nullptr;
+		Buffer* buffer = nullptr;
+		ResourceStates state_before = ResourceStates::kCommon;
+		ResourceStates state_after = ResourceStates::kCommon;
+		uint32_t subresource = ~0u;
+		ResourceBarrierFlags flags = ResourceBarrierFlags::kNone;
+	};
+
+	// Binds of a command list since it was created, elided binds matched the bound state and were not recorded
+	struct CommandListStats
+	{
+		uint64_t issued_binds = 0;
+		uint64_t elided_binds = 0;
+	};
+
 	class CommandList : public Resource
 	{
 	public:
@@ -27,6 +56,12 @@ namespace light::rhi
 
 		virtual void TransitionBarrier(Texture* texture, ResourceStates state_afeter, uint32_t subresource = ~0, bool flush_barriers = false, bool permanent = true) = 0;
 
+		// Issue a batch of planned barriers with one call, resources in permanent state skip the state tracking
+		virtual void ResourceBarriers(uint32_t num_barriers, const ResourceBarrier* barriers) = 0;
+
+		// without split barriers callers drop kBeginOnly and record kEndOnly as a full transition
+		virtual bool SupportsSplitBarriers() const { return false; }
+
 		virtual void ClearTexture(Texture* texture, const float* clear_value) = 0;
 
 		virtual void ClearTexture(Texture* texture, uint32_t mip_level, uint32_t array_slice, uint32_t num_array_slice, const float* clear_value) = 0;
@@ -73,23 +108,48 @@ namespace light::rhi
 
 		//virtual void SetShaderResourceView(uint32_t parameter_index,Texture* texture,ResourceStates state_after = ResourceStates::)
 
+		// binds a prebaked table to a descriptor table parameter, no transitions are recorded for the viewed resources
+		virtual void SetGraphicsDescriptorTable(uint32_t parameter_index, DescriptorTable* table) = 0;
+
 		virtual void SetGraphicsPipeline(GraphicsPipeline* pso) = 0;
 
 		virtual void SetPrimitiveTopology(PrimitiveTopology primitive_topology) = 0;
 
-		virtual void SetVertexBuffer(uint32_t slot, Buffer* buffer) = 0;
+		// binds consecutive slots with one call, a null buffer unbinds its slot, offsets default to 0
+		virtual void SetVertexBuffers(uint32_t start_slot, uint32_t num_buffers, Buffer* const* buffers, const uint32_t* offsets = nullptr) = 0;
+
+		void SetVertexBuffer(uint32_t slot, Buffer* buffer)
+		{
+			SetVertexBuffers(slot, 1, &buffer);
+		}
 
 		virtual void SetIndexBuffer(Buffer* buffer) = 0;
 
 		virtual void SetRenderTarget(const RenderTarget& target) = 0;
 
-		virtual void SetViewport(const Viewport& viewport) = 0;
+		virtual void SetViewports(uint32_t num_viewports, const Viewport* viewports) = 0;
+
+		void SetViewport(const Viewport& viewport)
+		{
+			SetViewports(1, &viewport);
+		}
+
+		void SetViewports(const std::vector<Viewport>& viewports)
+		{
+			SetViewports(static_cast<uint32_t>(viewports.size()), viewports.data());
+		}
 
-		virtual void SetViewports(const std::vector<Viewport>& viewports) = 0;
+		virtual void SetScissorRects(uint32_t num_rects, const Rect* rects) = 0;
 
-		virtual void SetScissorRect(const Rect& rect) = 0;
+		void SetScissorRect(const Rect& rect)
+		{
+			SetScissorRects(1, &rect);
+		}
 
-		virtual void SetScissorRects(const std::vector<Rect>& rects) = 0;
+		void SetScissorRects(const std::vector<Rect>& rects)
+		{
+			SetScissorRects(static_cast<uint32_t>(rects.size()), rects.data());
+		}
 
 		virtual void ExecuteCommandList() = 0;
 
@@ -101,15 +161,51 @@ namespace light::rhi
 
 		virtual void DrawIndexed(uint32_t index_count,uint32_t instance_count,uint32_t start_index,int32_t base_vertex,uint32_t start_instance) = 0;
 
+		virtual void Draw(uint32_t vertex_count, uint32_t instance_count, uint32_t start_vertex, uint32_t start_instance) = 0;
+
+		// Issues up to max_draw_count draws with one call, argument_buffer holds DrawArguments starting at argument_offset.
+		// With a count buffer the gpu reads the draw count from the uint32_t at count_offset, clamped to max_draw_count.
+		// Both buffers are transitioned to kIndirectArgument, arguments outside of them skip the draw.
+		virtual void DrawIndirect(Buffer* argument_buffer, uint64_t argument_offset, uint32_t max_draw_count,
+			Buffer* count_buffer = nullptr, uint64_t count_offset = 0) = 0;
+
+		// same as DrawIndirect with DrawIndexedArguments
+		virtual void DrawIndexedIndirect(Buffer* argument_buffer, uint64_t argument_offset, uint32_t max_draw_count,
+			Buffer* count_buffer = nullptr, uint64_t count_offset = 0) = 0;
+
+		const CommandListStats& GetStats() const { return stats_; }
+
 	protected:
 
+		// layout checks of the indirect draws shared by the backends, also done in release builds,
+		// false if the gpu would read outside the buffers and the draw has to be skipped
+		static bool CheckIndirectArguments(const Buffer* argument_buffer, uint64_t argument_offset, uint32_t stride, uint32_t max_draw_count,
+			const Buffer* count_buffer, uint64_t count_offset)
+		{
+			if (!argument_buffer || argument_offset % sizeof(uint32_t) != 0
+				|| argument_offset + static_cast<uint64_t>(stride) * max_draw_count > argument_buffer->GetDesc().size_in_bytes)
+			{
+				CHECK(false, "indirect draws need a 4 byte aligned argument range holding max_draw_count arguments");
+				return false;
+			}
+
+			if (count_buffer && (count_offset % sizeof(uint32_t) != 0 || count_offset + sizeof(uint32_t) > count_buffer->GetDesc().size_in_bytes))
+			{
+				CHECK(false, "the draw count has to be a 4 byte aligned uint32_t inside the count buffer");
+				return false;
+			}
+
+			return true;
+		}
+
 		virtual void TrackResource(Resource* resource) = 0;
 
 		virtual void FlushResourceBarriers() = 0;
 
 		CommandListType type_;
 		CommandQueue* queue_;
+		CommandListStats stats_;
 	};
 
 	using CommandListHandle = Handle<CommandList>;
-}
+}
\ No newline at end of file
@@ -17,11 +17,14 @@ namespace light::rhi
 		virtual CommandListHandle GetCommandList() = 0;
 
 		virtual uint64_t ExecuteCommandList(CommandList* command_list) = 0;
-		virtual uint64_t ExecuteCommandLists(uint64_t num, CommandList* command_lists) = 0;
+		virtual uint64_t ExecuteCommandLists(uint64_t num, CommandList* const* command_lists) = 0;
 
 		// fenceź
 		virtual uint64_t Signal() = 0;
 
+		// gpu side wait until queue reached fence_value, does not block the cpu
+		virtual void Wait(CommandQueue* queue, uint64_t fence_value) = 0;
+
 		virtual bool IsFenceCompleted(uint64_t fence_value) = 0;
 		virtual void WaitForFenceValue(uint64_t fence_value) = 0;
 
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "resource.h"
+#include "types.h"
+
+namespace light::rhi
+{
+	class Buffer;
+	class Texture;
+
+	// Contiguous block of shader visible srv/uav descriptors, written once and bound with a single root descriptor table.
+	// Writing a descriptor the gpu may still read is not allowed, create a new table instead.
+	// The table keeps the viewed resources alive, their states are up to the caller.
+	class DescriptorTable : public Resource
+	{
+	public:
+		explicit DescriptorTable(uint32_t num_descriptors)
+			: num_descriptors_(num_descriptors)
+		{
+
+		}
+
+		uint32_t GetNumDescriptors() const { return num_descriptors_; }
+
+		virtual void SetShaderResourceView(uint32_t index, Texture* texture,
+			Format format = Format::UNKNOWN,
+			TextureDimension dimension = TextureDimension::kTexture2D,
+			uint32_t mip_level = 0, uint32_t num_mip_levels = -1,
+			uint32_t array_slice = 0, uint32_t num_array_slices = -1) = 0;
+
+		virtual void SetUnorderedAccessView(uint32_t index, Texture* texture,
+			Format format = Format::UNKNOWN,
+			TextureDimension dimension = TextureDimension::kTexture2D,
+			uint32_t mip_level = 0,
+			uint32_t array_slice = 0, uint32_t num_array_slices = -1) = 0;
+
+		virtual void SetStructuredBufferView(uint32_t index, Buffer* buffer, uint32_t offset, uint32_t byte_size) = 0;
+
+		virtual void SetUnoderedAccessBufferView(uint32_t index, Buffer* buffer, uint32_t offset, uint32_t byte_size) = 0;
+	protected:
+		uint32_t num_descriptors_;
+	};
+
+	using DescriptorTableHandle = Handle<DescriptorTable>;
+}
\ No newline at end of file
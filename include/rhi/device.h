@@ -9,6 +9,7 @@
 #include "render_target.h"
 #include "command_queue.h"
 #include "command_list.h"
+#include "descriptor_table.h"
 #include "types.h"
 
 namespace light::rhi
@@ -33,6 +34,9 @@ namespace light::rhi
 		virtual InputLayoutHandle CreateInputLayout(std::vector<VertexAttributeDesc> attributes) = 0;
 		virtual GraphicsPipelineHandle CreateGraphicsPipeline(GraphicsPipelineDesc desc, const RenderTarget& render_target) = 0;
 
+		// nullptr if the backend has no shader visible descriptor tables, callers fall back to binding views one by one
+		virtual DescriptorTableHandle CreateDescriptorTable(uint32_t) { return nullptr; }
+
 		virtual CommandQueue* GetCommandQueue(CommandListType type) = 0;
 		virtual CommandListHandle GetCommandList(CommandListType type) = 0;
 
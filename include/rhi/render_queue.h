@@ -0,0 +1,100 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "command_list.h"
+#include "graphics_pipeline.h"
+#include "descriptor_table.h"
+
+namespace light::rhi
+{
+	// Everything one DrawIndexed binds, the queue keeps raw pointers, the objects have to outlive the Flush
+	struct DrawItem
+	{
+		GraphicsPipeline* pipeline = nullptr;
+		PrimitiveTopology primitive_topology = PrimitiveTopology::kTriangleList;
+
+		Buffer* vertex_buffer = nullptr;
+		Buffer* index_buffer = nullptr;
+
+		// the material, nullptr binds nothing
+		DescriptorTable* descriptor_table = nullptr;
+		uint32_t descriptor_table_parameter = 0;
+
+		// per draw root constants, copied into the queue on Submit
+		uint32_t constants_parameter = 0;
+		uint32_t num_constants = 0;
+		const void* constants = nullptr;
+
+		uint32_t index_count = 0;
+		uint32_t instance_count = 1;
+		uint32_t start_index = 0;
+		int32_t base_vertex = 0;
+		uint32_t start_instance = 0;
+	};
+
+	// Collects the draws of a pass from any number of threads and records them sorted by state instead of submission order.
+	// Every thread submits into its own bucket, Flush merges the buckets, radix sorts the 64 bit keys and replays the items
+	// through the command list, binds equal to the previous item are not issued, the command list elides the rest.
+	// Key from the most significant bits: binding layout, pipeline, material, vertex/index buffers, depth, front to back.
+	// Flush numbers the binding layouts, pipelines and materials in first use order, so up to 256 layouts and 4096 pipelines
+	// and materials never share a key field, more wrap around and only cost a rebind.
+	class RenderQueue
+	{
+	public:
+		explicit RenderQueue(uint32_t num_buckets = 1);
+
+		RenderQueue(const RenderQueue&) = delete;
+		RenderQueue& operator=(const RenderQueue&) = delete;
+
+		uint32_t GetNumBuckets() const { return static_cast<uint32_t>(buckets_.size()); }
+
+		// depth in [0, 1], only one thread may submit into a bucket at a time
+		void Submit(uint32_t bucket, const DrawItem& item, float depth = 0.0f);
+
+		// render target, viewports and scissors are up to the caller
+		void Flush(CommandList* command_list);
+
+		// 0 uses every hardware thread
+		void SetMaxSortThreads(uint32_t num_threads) { max_sort_threads_ = num_threads; }
+
+		uint32_t GetNumItems() const;
+	private:
+		struct Bucket
+		{
+			std::vector<DrawItem> items;
+			// buffers and depth, Flush adds the ids
+			std::vector<uint64_t> keys;
+			// item i reads its root constants from constants[constant_offsets[i]]
+			std::vector<uint32_t> constant_offsets;
+			std::vector<uint32_t> constants;
+		};
+
+		struct SortEntry
+		{
+			uint64_t key;
+			uint32_t bucket;
+			uint32_t item;
+		};
+
+		// the low bits of the key, Submit computes them on the submitting thread
+		static uint64_t ComputeDrawKey(const DrawItem& item, float depth);
+
+		uint64_t GetPipelineKey(const GraphicsPipeline* pipeline);
+		uint64_t GetMaterialKey(const DescriptorTable* descriptor_table);
+
+		void Sort();
+
+		std::vector<Bucket> buckets_;
+
+		// key bits of the pipelines with their binding layouts and of the materials, cleared by every Flush
+		std::unordered_map<const GraphicsPipeline*, uint64_t> pipeline_keys_;
+		std::unordered_map<const void*, uint32_t> layout_ids_;
+		std::unordered_map<const DescriptorTable*, uint64_t> material_keys_;
+
+		std::vector<SortEntry> entries_;
+		std::vector<SortEntry> scratch_entries_;
+		uint32_t max_sort_threads_ = 0;
+	};
+}
\ No newline at end of file
@@ -2,13 +2,14 @@
 
 #include <atomic>
 #include <cassert>
+#include <cstdint>
 
 namespace light::rhi
 {
 	struct Resource
 	{
 		Resource() = default;
-		virtual ~Resource() = 0 {}
+		virtual ~Resource() = 0;
 
 		// Non-copyable and non-movable
 		Resource(const Resource&) = delete;
@@ -34,6 +35,9 @@ namespace light::rhi
 		std::atomic<uint32_t> ref_count_{ 1 };
 	};
 
+	// pure virtual with a body, defined out of class to stay standard c++
+	inline Resource::~Resource() {}
+
     //////////////////////////////////////////////////////////////////////////
     // Handle
     // Mostly a copy of Microsoft::WRL::ComPtr<T>
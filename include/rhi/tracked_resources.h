@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "resource.h"
+
+namespace light::rhi
+{
+	// Resources a command list keeps alive until it is reset, each one retained once no matter how often it is bound.
+	// An open addressed pointer set in front of the handles, Track is a probe for the common already tracked case and
+	// costs an AddRef only for a new resource. Not thread safe, a list records on one thread.
+	class TrackedResources
+	{
+	public:
+		TrackedResources() = default;
+
+		TrackedResources(const TrackedResources&) = delete;
+		TrackedResources& operator=(const TrackedResources&) = delete;
+
+		// true if the resource was not tracked yet and is retained now
+		bool Track(Resource* resource)
+		{
+			if (!resource)
+			{
+				return false;
+			}
+
+			// keeps the load factor at most 1/2
+			if ((resources_.size() + 1) * 2 > slots_.size())
+			{
+				Grow();
+			}
+
+			auto slot = Find(resource);
+			if (slots_[slot])
+			{
+				return false;
+			}
+
+			slots_[slot] = resource;
+			resources_.emplace_back(resource);
+			return true;
+		}
+
+		// releases the resources, the capacity stays for the next recording
+		void Clear()
+		{
+			if (resources_.empty())
+			{
+				return;
+			}
+
+			std::fill(slots_.begin(), slots_.end(), nullptr);
+			resources_.clear();
+		}
+
+		size_t GetNumResources() const { return resources_.size(); }
+	private:
+		size_t Find(const Resource* resource) const
+		{
+			// fibonacci hashing, the top bits of the product depend on every bit of the pointer
+			auto mask = slots_.size() - 1;
+			auto slot = static_cast<size_t>((reinterpret_cast<uintptr_t>(resource) * 0x9e3779b97f4a7c15ull) >> shift_);
+			while (slots_[slot] && slots_[slot] != resource)
+			{
+				slot = (slot + 1) & mask;
+			}
+			return slot;
+		}
+
+		void Grow()
+		{
+			slots_.assign(std::max<size_t>(slots_.size() * 2, kMinSlots), nullptr);
+			shift_ = 64;
+			for (auto size = slots_.size(); size > 1; size >>= 1)
+			{
+				--shift_;
+			}
+
+			for (auto& resource : resources_)
+			{
+				slots_[Find(resource.Get())] = resource.Get();
+			}
+		}
+
+		static constexpr size_t kMinSlots = 64;
+
+		std::vector<const Resource*> slots_;
+		uint32_t shift_ = 64;
+		std::vector<ResourceHandle> resources_;
+	};
+}
\ No newline at end of file
@@ -42,6 +42,8 @@ namespace light::rhi
 		kVideoEncodeWrite = 0x800000
 	};
 
+	RHI_ENUM_CLASS_FLAG_OPERATORS(ResourceStates);
+
 	enum class CpuAccess : uint8_t
 	{
 		kNone,		// CPU˷
@@ -384,6 +386,25 @@ namespace light::rhi
 		int32_t bottom;
 	};
 
+	// entry of an argument buffer read by CommandList::DrawIndirect
+	struct DrawArguments
+	{
+		uint32_t vertex_count;
+		uint32_t instance_count;
+		uint32_t start_vertex;
+		uint32_t start_instance;
+	};
+
+	// entry of an argument buffer read by CommandList::DrawIndexedIndirect
+	struct DrawIndexedArguments
+	{
+		uint32_t index_count;
+		uint32_t instance_count;
+		uint32_t start_index;
+		int32_t base_vertex;
+		uint32_t start_instance;
+	};
+
 	struct SampleDesc
 	{
 		uint32_t count;
@@ -42,6 +42,8 @@ namespace light::rhi
 
 	D3D12_CPU_DESCRIPTOR_HANDLE D12Buffer::GetCBV()
 	{
+		std::lock_guard<std::mutex> lock(view_mutex_);
+
 		if(cbv_.IsNull())
 		{
 			cbv_ = device_->AllocateDescriptors(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 1);
@@ -61,6 +63,8 @@ namespace light::rhi
 
 	D3D12_CPU_DESCRIPTOR_HANDLE D12Buffer::GetSBV(uint32_t offset, uint32_t byte_size)
 	{
+		std::lock_guard<std::mutex> lock(view_mutex_);
+
 		size_t hash = 0;
 
 		HashCombine(hash, offset);
@@ -91,6 +95,8 @@ namespace light::rhi
 
 	D3D12_CPU_DESCRIPTOR_HANDLE D12Buffer::GetUBV(uint32_t offset, uint32_t byte_size)
 	{
+		std::lock_guard<std::mutex> lock(view_mutex_);
+
 		// todo
 		assert(desc_.is_uav && "is not uav");
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <mutex>
 
 #include "d3dx12.h"
 #include "rhi/buffer.h"
@@ -28,5 +29,8 @@ namespace light::rhi
 		DescriptorAllocation cbv_;
 		std::unordered_map<size_t, DescriptorAllocation> sbv_map_;
 		std::unordered_map<size_t, DescriptorAllocation> ubv_map_;
+
+		// views are created lazily, possibly from several recording threads
+		std::mutex view_mutex_;
 	};
 }
\ No newline at end of file
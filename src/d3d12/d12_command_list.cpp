@@ -1,5 +1,6 @@
 #include "d12_command_list.h"
 
+#include <algorithm>
 #include <array>
 
 #include "d12_device.h"
@@ -86,6 +87,92 @@ namespace light::rhi
 		}
 	}
 
+	void D12CommandList::ResourceBarriers(uint32_t num_barriers, const ResourceBarrier* barriers)
+	{
+		for (uint32_t i = 0; i < num_barriers; ++i)
+		{
+			const ResourceBarrier& barrier = barriers[i];
+
+			ID3D12Resource* native = nullptr;
+			bool permanent = false;
+			if (barrier.texture)
+			{
+				native = CheckedCast<D12Texture*>(barrier.texture)->GetNative();
+				permanent = barrier.texture->IsPermanentState();
+				TrackResource(barrier.texture);
+			}
+			else if (barrier.buffer)
+			{
+				native = CheckedCast<D12Buffer*>(barrier.buffer)->GetNative();
+				permanent = barrier.buffer->IsPermanentState();
+				TrackResource(barrier.buffer);
+			}
+			else
+			{
+				continue;
+			}
+
+			if (barrier.state_before == barrier.state_after)
+			{
+				if (barrier.state_after == ResourceStates::kUnorderedAccess)
+				{
+					resource_state_tracker_.ResourceBarrier(CD3DX12_RESOURCE_BARRIER::UAV(native));
+				}
+				continue;
+			}
+
+			auto transition = CD3DX12_RESOURCE_BARRIER::Transition(
+				native,
+				ConvertResourceStates(barrier.state_before),
+				ConvertResourceStates(barrier.state_after), barrier.subresource);
+
+			// a tracked resource can only begin early from the state this list left it in,
+			// otherwise the begin is dropped and the end becomes a full transition
+			if (barrier.flags == ResourceBarrierFlags::kBeginOnly)
+			{
+				D3D12_RESOURCE_STATES final_state;
+				if (permanent || (resource_state_tracker_.GetFinalState(native, barrier.subresource, final_state)
+					&& final_state == transition.Transition.StateBefore))
+				{
+					transition.Flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+					resource_state_tracker_.ExplicitBarrier(transition);
+					split_barriers_.emplace_back(native, barrier.subresource);
+				}
+				continue;
+			}
+
+			if (barrier.flags == ResourceBarrierFlags::kEndOnly)
+			{
+				auto it = std::find(split_barriers_.begin(), split_barriers_.end(), std::make_pair(native, static_cast<UINT>(barrier.subresource)));
+				if (it != split_barriers_.end())
+				{
+					*it = split_barriers_.back();
+					split_barriers_.pop_back();
+
+					transition.Flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+					resource_state_tracker_.ExplicitBarrier(transition);
+					if (!permanent)
+					{
+						resource_state_tracker_.SetFinalState(native, barrier.subresource, transition.Transition.StateAfter);
+					}
+					continue;
+				}
+			}
+
+			// the owner of a permanent state resource plans its states, no need to look them up
+			if (permanent)
+			{
+				resource_state_tracker_.ExplicitBarrier(transition);
+			}
+			else
+			{
+				resource_state_tracker_.ResourceBarrier(transition);
+			}
+		}
+
+		FlushResourceBarriers();
+	}
+
 	void D12CommandList::ClearTexture(Texture* texture, const float* clear_value)
 	{
 		auto d12_texture = CheckedCast<D12Texture*>(texture);
@@ -161,22 +248,41 @@ namespace light::rhi
 
 	void D12CommandList::SetGraphicsDynamicConstantBuffer(uint32_t parameter_index, size_t bytes, const void* data)
 	{
+		// the same data as the bound upload memory needs neither a new allocation nor a bind
+		auto bound_data = bound_state_.constant_buffer_data[parameter_index];
+		if (SkipBind(bound_data && bound_state_.constant_buffer_sizes[parameter_index] == bytes && memcmp(bound_data, data, bytes) == 0))
+		{
+			return;
+		}
+
 		UploadBuffer::Allocation allocation = upload_buffer_.Allocate(bytes, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
 
 		memcpy(allocation.cpu, data, bytes);
 
-		//if (buffer_states_[parameter_index] != allocation.gpu)
-		{
-			d3d12_command_list_->SetGraphicsRootConstantBufferView(parameter_index, allocation.gpu);
-		}
+		d3d12_command_list_->SetGraphicsRootConstantBufferView(parameter_index, allocation.gpu);
 
-		buffer_states_[parameter_index] = allocation.gpu;
+		bound_state_.constant_buffers[parameter_index] = allocation.gpu;
+		bound_state_.constant_buffer_data[parameter_index] = allocation.cpu;
+		bound_state_.constant_buffer_sizes[parameter_index] = bytes;
 	}
 
 	void D12CommandList::SetGraphics32BitConstants(uint32_t parameter_index, uint32_t num_constants,
 		const void* constants)
 	{
+		CHECK(num_constants <= kMaxRootConstants, "root constants exceed the root signature limit");
+
+		auto& bound_constants = bound_state_.constants[parameter_index];
+		if (SkipBind(bound_constants.num_constants == num_constants
+			&& memcmp(bound_constants.values.data(), constants, num_constants * sizeof(uint32_t)) == 0))
+		{
+			return;
+		}
+
 		d3d12_command_list_->SetGraphicsRoot32BitConstants(parameter_index, num_constants, constants, 0);
+
+		// more than fit are never elided
+		bound_constants.num_constants = std::min(num_constants, kMaxRootConstants);
+		memcpy(bound_constants.values.data(), constants, bound_constants.num_constants * sizeof(uint32_t));
 	}
 
 	void D12CommandList::SetBufferView(uint32_t parameter_index, Buffer* buffer, uint32_t offset,
@@ -251,21 +357,59 @@ namespace light::rhi
 			d12_texture->GetSRV(format, dimension, mip_level, num_mip_leves, array_slice, num_array_slices));
 	}
 
+	void D12CommandList::SetGraphicsDescriptorTable(uint32_t parameter_index, DescriptorTable* table)
+	{
+		auto d12_table = CheckedCast<D12DescriptorTable*>(table);
+
+		// the tables share a heap with the staged descriptors, only a table of another page switches it
+		auto heap = d12_table->GetDescriptorHeap();
+		if (descriptr_heaps_[D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV] != heap)
+		{
+			SetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, heap);
+			CommitDescriptorHeaps();
+		}
+
+		// the table replaces the descriptors staged for the parameter
+		dynamic_descriptor_heaps_[D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV]->UnstageDescriptorTable(parameter_index);
+
+		SetGraphicsRootDescriptorTable(parameter_index, d12_table->GetGpuDescriptorHandle());
+
+		TrackResource(table);
+	}
+
+	void D12CommandList::SetGraphicsRootDescriptorTable(uint32_t parameter_index, D3D12_GPU_DESCRIPTOR_HANDLE descriptor)
+	{
+		if (!SkipBind(bound_state_.descriptor_tables[parameter_index] == descriptor.ptr))
+		{
+			d3d12_command_list_->SetGraphicsRootDescriptorTable(parameter_index, descriptor);
+			bound_state_.descriptor_tables[parameter_index] = descriptor.ptr;
+		}
+	}
+
 	void D12CommandList::SetGraphicsPipeline(GraphicsPipeline* pso)
 	{
-		if(current_pso_ != pso)
+		if (!SkipBind(current_pso_ == pso))
 		{
 			auto d12_pso = CheckedCast<D12GraphicsPipeline*>(pso);
 
+			// pipelines sharing a root signature keep the bound root parameters
 			auto root_sigature = d12_pso->GetRootSignature();
-			d3d12_command_list_->SetGraphicsRootSignature(root_sigature->GetNative());
-			
-			for (auto& dynamic_descriptor_heap : dynamic_descriptor_heaps_)
+			if (!SkipBind(bound_state_.root_signature == root_sigature->GetNative()))
 			{
-				dynamic_descriptor_heap->ParseRootSignature(root_sigature);
+				d3d12_command_list_->SetGraphicsRootSignature(root_sigature->GetNative());
+
+				for (auto& dynamic_descriptor_heap : dynamic_descriptor_heaps_)
+				{
+					dynamic_descriptor_heap->ParseRootSignature(root_sigature);
+				}
+
+				bound_state_.root_signature = root_sigature->GetNative();
+				bound_state_.ResetRootParameters();
 			}
 
 			d3d12_command_list_->SetPipelineState(d12_pso->GetNative());
+
+			current_pso_ = pso;
 		}
 
 		TrackResource(pso);
@@ -273,26 +417,55 @@ namespace light::rhi
 
 	void D12CommandList::SetPrimitiveTopology(PrimitiveTopology primitive_topology)
 	{
-		d3d12_command_list_->IASetPrimitiveTopology(ConvertPrimitiveTopology(primitive_topology));
+		auto topology = ConvertPrimitiveTopology(primitive_topology);
+		if (!SkipBind(bound_state_.primitive_topology == topology))
+		{
+			d3d12_command_list_->IASetPrimitiveTopology(topology);
+			bound_state_.primitive_topology = topology;
+		}
 	}
 
-	void D12CommandList::SetVertexBuffer(uint32_t slot, Buffer* buffer)
+	void D12CommandList::SetVertexBuffers(uint32_t start_slot, uint32_t num_buffers, Buffer* const* buffers, const uint32_t* offsets)
 	{
-		const BufferDesc& desc = buffer->GetDesc();
+		CHECK(start_slot + num_buffers <= D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT, "vertex buffer slots out of range");
 
-		CHECK(desc.type == BufferType::kVertex, "bufferTypeVertexBuffer");
+		std::array<D3D12_VERTEX_BUFFER_VIEW, D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT> views{};
 
-		auto d12_buffer = CheckedCast<D12Buffer*>(buffer);
+		for (uint32_t i = 0; i < num_buffers; ++i)
+		{
+			if (!buffers[i])
+			{
+				continue;
+			}
 
-		TrackResource(buffer);
-		TransitionBarrier(buffer, ResourceStates::kVertexAndConstantBuffer);
+			CHECK(buffers[i]->GetDesc().type == BufferType::kVertex, "bufferTypeVertexBuffer");
 
-		D3D12_VERTEX_BUFFER_VIEW view{};
-		view.BufferLocation = d12_buffer->GetNative()->GetGPUVirtualAddress();
-		view.SizeInBytes = desc.size_in_bytes;
-		view.StrideInBytes = desc.stride;
+			const BufferDesc& desc = buffers[i]->GetDesc();
+			uint32_t offset = offsets ? offsets[i] : 0;
+			if (offset > desc.size_in_bytes)
+			{
+				// the slot keeps a null view in release builds instead of a size that wrapped around
+				CHECK(false, "vertex buffer offset past the end of the buffer");
+				continue;
+			}
+
+			auto d12_buffer = CheckedCast<D12Buffer*>(buffers[i]);
+
+			TrackResource(buffers[i]);
+			TransitionBarrier(buffers[i], ResourceStates::kVertexAndConstantBuffer);
 
-		d3d12_command_list_->IASetVertexBuffers(slot, 1, &view);
+			views[i].BufferLocation = d12_buffer->GetNative()->GetGPUVirtualAddress() + offset;
+			views[i].SizeInBytes = static_cast<UINT>(desc.size_in_bytes - offset);
+			views[i].StrideInBytes = desc.stride;
+		}
+
+		if (SkipBind(memcmp(&bound_state_.vertex_buffers[start_slot], views.data(), num_buffers * sizeof(D3D12_VERTEX_BUFFER_VIEW)) == 0))
+		{
+			return;
+		}
+
+		d3d12_command_list_->IASetVertexBuffers(start_slot, num_buffers, views.data());
+		std::copy(views.begin(), views.begin() + num_buffers, bound_state_.vertex_buffers.begin() + start_slot);
 	}
 
 	void D12CommandList::SetIndexBuffer(Buffer* buffer)
@@ -310,7 +483,12 @@ namespace light::rhi
 		view.BufferLocation = d12_buffer->GetNative()->GetGPUVirtualAddress();
 		view.SizeInBytes = static_cast<UINT>(desc.size_in_bytes);
 		view.Format = GetDxgiFormatMapping(buffer->GetDesc().format).srv_format;
-		d3d12_command_list_->IASetIndexBuffer(&view);
+
+		if (!SkipBind(memcmp(&bound_state_.index_buffer, &view, sizeof(view)) == 0))
+		{
+			d3d12_command_list_->IASetIndexBuffer(&view);
+			bound_state_.index_buffer = view;
+		}
 	}
 
 	void D12CommandList::SetRenderTarget(const RenderTarget& render_target)
@@ -364,48 +542,75 @@ namespace light::rhi
 			TrackResource(d12_depth_texture);
 		}
 
+		// the transitions above are still needed, only the native bind is skipped
+		bool bound = bound_state_.render_target_bound
+			&& bound_state_.num_render_targets == num_render_target
+			&& bound_state_.depth_stencil.ptr == depth_stencil_descriptor.ptr
+			&& std::equal(render_target_descriptors.begin(), render_target_descriptors.begin() + num_render_target, bound_state_.render_targets.begin(),
+				[](const D3D12_CPU_DESCRIPTOR_HANDLE& a, const D3D12_CPU_DESCRIPTOR_HANDLE& b) { return a.ptr == b.ptr; });
+
+		if (SkipBind(bound))
+		{
+			return;
+		}
+
 		D3D12_CPU_DESCRIPTOR_HANDLE* dsv = depth_stencil_descriptor.ptr != 0 ? &depth_stencil_descriptor : nullptr;
 		d3d12_command_list_->OMSetRenderTargets(num_render_target, render_target_descriptors.data(), false, dsv);
 
+		bound_state_.render_target_bound = true;
+		bound_state_.num_render_targets = num_render_target;
+		std::copy(render_target_descriptors.begin(), render_target_descriptors.begin() + num_render_target, bound_state_.render_targets.begin());
+		bound_state_.depth_stencil = depth_stencil_descriptor;
+
 		ThrowIfFailed(device_->GetNative()->GetDeviceRemovedReason());
 	}
 
-	void D12CommandList::SetViewport(const Viewport& viewport)
+	void D12CommandList::SetViewports(uint32_t num_viewports, const Viewport* viewports)
 	{
-		SetViewports({ viewport });
-	}
+		std::array<D3D12_VIEWPORT, D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE> d12_viewports;
+		CHECK(num_viewports <= d12_viewports.size(), "too many viewports");
+		num_viewports = std::min<uint32_t>(num_viewports, d12_viewports.size());
 
-	void D12CommandList::SetViewports(const std::vector<Viewport>& viewports)
-	{
-		std::vector<D3D12_VIEWPORT> d12_viewports;
-		d12_viewports.reserve(viewports.size());
+		for (uint32_t i = 0; i < num_viewports; ++i)
+		{
+			d12_viewports[i] = ConvertViewport(viewports[i]);
+		}
 
-		for (auto& viewport : viewports)
+		if (SkipBind(bound_state_.num_viewports == num_viewports
+			&& memcmp(bound_state_.viewports.data(), d12_viewports.data(), num_viewports * sizeof(D3D12_VIEWPORT)) == 0))
 		{
-			d12_viewports.emplace_back(ConvertViewport(viewport));
+			return;
 		}
 
-		d3d12_command_list_->RSSetViewports(d12_viewports.size(), d12_viewports.data());
+		d3d12_command_list_->RSSetViewports(num_viewports, d12_viewports.data());
+
+		bound_state_.num_viewports = num_viewports;
+		bound_state_.viewports = d12_viewports;
 
 		ThrowIfFailed(device_->GetNative()->GetDeviceRemovedReason());
 	}
 
-	void D12CommandList::SetScissorRect(const Rect& rect)
+	void D12CommandList::SetScissorRects(uint32_t num_rects, const Rect* rects)
 	{
-		SetScissorRects({ rect });
-	}
+		std::array<D3D12_RECT, D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE> d12_rects;
+		CHECK(num_rects <= d12_rects.size(), "too many scissor rects");
+		num_rects = std::min<uint32_t>(num_rects, d12_rects.size());
 
-	void D12CommandList::SetScissorRects(const std::vector<Rect>& rects)
-	{
-		std::vector<D3D12_RECT> d12_rects;
-		d12_rects.reserve(rects.size());
+		for (uint32_t i = 0; i < num_rects; ++i)
+		{
+			d12_rects[i] = ConvertRect(rects[i]);
+		}
 
-		for (auto& rect : rects)
+		if (SkipBind(bound_state_.num_scissor_rects == num_rects
+			&& memcmp(bound_state_.scissor_rects.data(), d12_rects.data(), num_rects * sizeof(D3D12_RECT)) == 0))
 		{
-			d12_rects.emplace_back(ConvertRect(rect));
+			return;
 		}
 
-		d3d12_command_list_->RSSetScissorRects(d12_rects.size(), d12_rects.data());
+		d3d12_command_list_->RSSetScissorRects(num_rects, d12_rects.data());
+
+		bound_state_.num_scissor_rects = num_rects;
+		bound_state_.scissor_rects = d12_rects;
 
 		ThrowIfFailed(device_->GetNative()->GetDeviceRemovedReason());
 	}
@@ -442,19 +647,82 @@ namespace light::rhi
 		ThrowIfFailed(d3d12_command_allocator_->Reset());
 		ThrowIfFailed(d3d12_command_list_->Reset(d3d12_command_allocator_.Get(),nullptr));
 
-		track_resources_.clear();
+		track_resources_.Clear();
+		split_barriers_.clear();
+		std::fill(std::begin(descriptr_heaps_), std::end(descriptr_heaps_), nullptr);
+
+		// the allocator reset, the gpu is done with the descriptors copied for the previous recording
+		for (auto& dynamic_descriptor_heap : dynamic_descriptor_heaps_)
+		{
+			dynamic_descriptor_heap->Rest();
+		}
 
 		upload_buffer_.Rest();
 
 		current_pso_ = nullptr;
+		bound_state_.Reset();
 	}
 
 	void D12CommandList::DrawIndexed(uint32_t index_count, uint32_t instance_count, uint32_t start_index,
 	                                 int32_t base_vertex, uint32_t start_instance)
 	{
+		CommitStagedDescriptors();
+		FlushResourceBarriers();
 		d3d12_command_list_->DrawIndexedInstanced(index_count, instance_count, start_index, base_vertex, start_instance);
 	}
 
+	void D12CommandList::Draw(uint32_t vertex_count, uint32_t instance_count, uint32_t start_vertex, uint32_t start_instance)
+	{
+		CommitStagedDescriptors();
+		FlushResourceBarriers();
+		d3d12_command_list_->DrawInstanced(vertex_count, instance_count, start_vertex, start_instance);
+	}
+
+	void D12CommandList::DrawIndirect(Buffer* argument_buffer, uint64_t argument_offset, uint32_t max_draw_count,
+		Buffer* count_buffer, uint64_t count_offset)
+	{
+		ExecuteIndirect(device_->GetDrawCommandSignature(), argument_buffer, argument_offset, max_draw_count, count_buffer, count_offset);
+	}
+
+	void D12CommandList::DrawIndexedIndirect(Buffer* argument_buffer, uint64_t argument_offset, uint32_t max_draw_count,
+		Buffer* count_buffer, uint64_t count_offset)
+	{
+		ExecuteIndirect(device_->GetDrawIndexedCommandSignature(), argument_buffer, argument_offset, max_draw_count, count_buffer, count_offset);
+	}
+
+	void D12CommandList::ExecuteIndirect(D12CommandSignature* command_signature, Buffer* argument_buffer, uint64_t argument_offset,
+		uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset)
+	{
+		if (!CheckIndirectArguments(argument_buffer, argument_offset, command_signature->GetStride(), max_draw_count, count_buffer, count_offset))
+		{
+			return;
+		}
+
+		TrackResource(argument_buffer);
+		TransitionBarrier(argument_buffer, ResourceStates::kIndirectArgument);
+
+		ID3D12Resource* count_resource = nullptr;
+		if (count_buffer)
+		{
+			TrackResource(count_buffer);
+			TransitionBarrier(count_buffer, ResourceStates::kIndirectArgument);
+
+			count_resource = CheckedCast<D12Buffer*>(count_buffer)->GetNative();
+		}
+
+		CommitStagedDescriptors();
+		FlushResourceBarriers();
+
+		d3d12_command_list_->ExecuteIndirect(command_signature->GetNative(), max_draw_count,
+			CheckedCast<D12Buffer*>(argument_buffer)->GetNative(), argument_offset, count_resource, count_offset);
+	}
+
+	void D12CommandList::CommitStagedDescriptors()
+	{
+		dynamic_descriptor_heaps_[D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV]->CommitStatedDescriptorsForDraw(this);
+		dynamic_descriptor_heaps_[D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER]->CommitStatedDescriptorsForDraw(this);
+	}
+
 	void D12CommandList::CommitDescriptorHeaps()
 	{
 		uint32_t num_heaps = 0;
@@ -469,15 +737,41 @@ namespace light::rhi
 		}
 
 		d3d12_command_list_->SetDescriptorHeaps(num_heaps, heap);
+
+		// tables set before a heap change point into the previous heaps
+		bound_state_.ResetDescriptorTables();
+	}
+
+	void D12CommandList::BoundState::Reset()
+	{
+		*this = BoundState();
+	}
+
+	void D12CommandList::BoundState::ResetRootParameters()
+	{
+		constant_buffers.fill(0);
+		constant_buffer_data.fill(nullptr);
+		constant_buffer_sizes.fill(0);
+		descriptor_tables.fill(0);
+
+		for (auto& values : constants)
+		{
+			values.num_constants = 0;
+		}
+	}
+
+	void D12CommandList::BoundState::ResetDescriptorTables()
+	{
+		descriptor_tables.fill(0);
 	}
 
 	void D12CommandList::TrackResource(Resource* resource)
 	{
-		track_resources_.emplace_back(resource);
+		track_resources_.Track(resource);
 	}
 
 	void D12CommandList::FlushResourceBarriers()
 	{
 		resource_state_tracker_.FlushResourceBarriers(this);
 	}
-}
+}
\ No newline at end of file
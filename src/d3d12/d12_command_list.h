@@ -1,8 +1,10 @@
 #pragma once
 
+#include <array>
 #include <vector>
 
 #include "rhi/command_list.h"
+#include "rhi/tracked_resources.h"
 
 #include "upload_buffer.h"
 #include "resource_state_tracker.h"
@@ -14,6 +16,7 @@ namespace light::rhi
 {
 	class D12Device;
 	class D12CommandQueue;
+	class D12CommandSignature;
 
 	class D12CommandList final : public CommandList
 	{
@@ -23,12 +26,24 @@ namespace light::rhi
 
 		void SetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE type,ID3D12DescriptorHeap* heap);
 
+		ID3D12DescriptorHeap* GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE type) const { return descriptr_heaps_[type]; }
+
+		// binds the heaps set with SetDescriptorHeap, the descriptor tables bound before are undefined after it
+		void CommitDescriptorHeaps();
+
+		// skipped if the descriptor is bound to the parameter already
+		void SetGraphicsRootDescriptorTable(uint32_t parameter_index, D3D12_GPU_DESCRIPTOR_HANDLE descriptor);
+
 		void TransitionBarrier(Buffer* buffer, ResourceStates state_afeter, uint32_t subresource = ~0, bool flush_barriers = false,
 		                       bool permanent = true) override;
 
 		void TransitionBarrier(Texture* texture, ResourceStates state_afeter, uint32_t subresource = ~0, bool flush_barriers = false,
 		                       bool permanent = true) override;
 
+		void ResourceBarriers(uint32_t num_barriers, const ResourceBarrier* barriers) override;
+
+		bool SupportsSplitBarriers() const override { return true; }
+
 		void ClearTexture(Texture* texture, const float* clear_value) override;
 
 		void ClearTexture(Texture* texture, uint32_t mip_level, uint32_t array_slice, uint32_t num_array_slice,
@@ -65,23 +80,21 @@ namespace light::rhi
 			Format format, TextureDimension dimension, uint32_t mip_level, uint32_t num_mip_leves, uint32_t array_slice,
 			uint32_t num_array_slices, ResourceStates state_after) override;
 
+		void SetGraphicsDescriptorTable(uint32_t parameter_index, DescriptorTable* table) override;
+
 		void SetGraphicsPipeline(GraphicsPipeline* pso) override;
 
 		void SetPrimitiveTopology(PrimitiveTopology primitive_topology) override;
 
-		void SetVertexBuffer(uint32_t slot, Buffer* buffer) override;
+		void SetVertexBuffers(uint32_t start_slot, uint32_t num_buffers, Buffer* const* buffers, const uint32_t* offsets) override;
 
 		void SetIndexBuffer(Buffer* buffer) override;
 
 		void SetRenderTarget(const RenderTarget& render_target) override;
 
-		void SetViewport(const Viewport& viewport) override;
-
-		void SetViewports(const std::vector<Viewport>& viewports) override;
+		void SetViewports(uint32_t num_viewports, const Viewport* viewports) override;
 
-		void SetScissorRect(const Rect& rect) override;
-
-		void SetScissorRects(const std::vector<Rect>& rects) override;
+		void SetScissorRects(uint32_t num_rects, const Rect* rects) override;
 
 		void ExecuteCommandList() override;
 
@@ -94,28 +107,92 @@ namespace light::rhi
 		void DrawIndexed(uint32_t index_count, uint32_t instance_count, uint32_t start_index, int32_t base_vertex,
 			uint32_t start_instance) override;
 
+		void Draw(uint32_t vertex_count, uint32_t instance_count, uint32_t start_vertex, uint32_t start_instance) override;
+
+		void DrawIndirect(Buffer* argument_buffer, uint64_t argument_offset, uint32_t max_draw_count,
+			Buffer* count_buffer, uint64_t count_offset) override;
+
+		void DrawIndexedIndirect(Buffer* argument_buffer, uint64_t argument_offset, uint32_t max_draw_count,
+			Buffer* count_buffer, uint64_t count_offset) override;
+
 		ID3D12GraphicsCommandList* GetD3D12GraphicsCommandList() { return d3d12_command_list_; }
 
 	protected:
-		void CommitDescriptorHeaps();
-
 		// Զ׷ʹеԴ
 		void TrackResource(Resource* resource) override;
 
 		void FlushResourceBarriers() override;
 	private:
+		// copies the staged descriptors into the shader visible heap and binds their tables
+		void CommitStagedDescriptors();
+
+		void ExecuteIndirect(D12CommandSignature* command_signature, Buffer* argument_buffer, uint64_t argument_offset,
+			uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset);
+
+		static constexpr uint32_t kMaxRootParameters = 64;
+		// dwords of a root signature, no root constant parameter holds more
+		static constexpr uint32_t kMaxRootConstants = 64;
+
+		struct BoundConstants
+		{
+			uint32_t num_constants = 0;
+			std::array<uint32_t, kMaxRootConstants> values;
+		};
+
+		// State recorded into the native list, binds matching it are counted as elided and skipped.
+		// Reset forgets all of it, a root signature change the root parameters and a descriptor heap change the tables
+		struct BoundState
+		{
+			ID3D12RootSignature* root_signature = nullptr;
+			D3D12_PRIMITIVE_TOPOLOGY primitive_topology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+			std::array<D3D12_VERTEX_BUFFER_VIEW, D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT> vertex_buffers{};
+			D3D12_INDEX_BUFFER_VIEW index_buffer{};
+
+			bool render_target_bound = false;
+			uint32_t num_render_targets = 0;
+			std::array<D3D12_CPU_DESCRIPTOR_HANDLE, D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT> render_targets{};
+			D3D12_CPU_DESCRIPTOR_HANDLE depth_stencil{};
+
+			uint32_t num_viewports = 0;
+			std::array<D3D12_VIEWPORT, D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE> viewports{};
+			uint32_t num_scissor_rects = 0;
+			std::array<D3D12_RECT, D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE> scissor_rects{};
+
+			// per root parameter, a dynamic constant buffer keeps pointing at its upload memory until Reset
+			std::array<D3D12_GPU_VIRTUAL_ADDRESS, kMaxRootParameters> constant_buffers{};
+			std::array<const void*, kMaxRootParameters> constant_buffer_data{};
+			std::array<size_t, kMaxRootParameters> constant_buffer_sizes{};
+			std::array<UINT64, kMaxRootParameters> descriptor_tables{};
+			std::array<BoundConstants, kMaxRootParameters> constants{};
+
+			void Reset();
+
+			void ResetRootParameters();
+
+			void ResetDescriptorTables();
+		};
+
+		// counts the bind, true if it matches the bound state and is skipped
+		bool SkipBind(bool bound)
+		{
+			++(bound ? stats_.elided_binds : stats_.issued_binds);
+			return bound;
+		}
+
 		D12Device* device_;
 		Handle<ID3D12CommandAllocator> d3d12_command_allocator_;
 		Handle<ID3D12GraphicsCommandList> d3d12_command_list_;
-		std::vector<ResourceHandle> track_resources_;
+		TrackedResources track_resources_;
 		std::vector<Handle<ID3D12Resource>> track_upload_resources_;
 		UploadBuffer upload_buffer_;
 		ResourceStateTracker resource_state_tracker_;
+		// split barriers begun but not ended yet
+		std::vector<std::pair<ID3D12Resource*, UINT>> split_barriers_;
 		std::unique_ptr<DynamicDescriptorHeap> dynamic_descriptor_heaps_[D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES];
 		GraphicsPipeline* current_pso_;
 		ID3D12DescriptorHeap* descriptr_heaps_[D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES];
 		D3D12_GPU_VIRTUAL_ADDRESS buffer_gpu_virtual_address_[32];
-		D3D12_GPU_VIRTUAL_ADDRESS buffer_states_[32];
+		BoundState bound_state_;
 	};
 
-}
+}
\ No newline at end of file
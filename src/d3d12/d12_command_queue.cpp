@@ -111,6 +111,12 @@ namespace light::rhi
 		return fence_value;
 	}
 
+	void D12CommandQueue::Wait(CommandQueue* queue, uint64_t fence_value)
+	{
+		auto d12_queue = CheckedCast<D12CommandQueue*>(queue);
+		queue_->Wait(d12_queue->GetFence(), fence_value);
+	}
+
 	bool D12CommandQueue::IsFenceCompleted(uint64_t fence_value)
 	{
 		return fence_->GetCompletedValue() >= fence_value;
@@ -143,10 +149,10 @@ namespace light::rhi
 
 	uint64_t D12CommandQueue::ExecuteCommandList(CommandList* command_list)
 	{
-		return ExecuteCommandLists(1, command_list);
+		return ExecuteCommandLists(1, &command_list);
 	}
 
-	uint64_t D12CommandQueue::ExecuteCommandLists(uint64_t num, CommandList* command_lists)
+	uint64_t D12CommandQueue::ExecuteCommandLists(uint64_t num, CommandList* const* command_lists)
 	{
 		std::unique_lock<std::mutex> lock(ResourceStateTracker::s_global_mutex);
 
@@ -157,22 +163,36 @@ namespace light::rhi
 		std::vector<ID3D12CommandList*> d3d12_command_lists;
 		d3d12_command_lists.reserve(num * 2);
 
+		// a pending list that received no barriers stays open for the next command list of the batch
+		CommandListHandle pending_command_list;
 		for (uint64_t i = 0; i < num; ++i)
 		{
-			auto pending_command_list = GetCommandList();
-			if (command_lists->Close(pending_command_list))
+			if (!pending_command_list)
+			{
+				pending_command_list = GetCommandList();
+			}
+
+			if (command_lists[i]->Close(pending_command_list))
 			{
 				auto d12_pending_command_list = CheckedCast<D12CommandList*>(pending_command_list.Get());
 
+				pending_command_list->Close();
 				d3d12_command_lists.push_back(d12_pending_command_list->GetD3D12GraphicsCommandList());
-			}
 
-			pending_command_list->Close();
+				flight_command_lists.push_back(pending_command_list);
+				pending_command_list = nullptr;
+			}
 
-			auto d12_command_list = CheckedCast<D12CommandList*>(&command_lists[i]);
+			auto d12_command_list = CheckedCast<D12CommandList*>(command_lists[i]);
 			d3d12_command_lists.push_back(d12_command_list->GetD3D12GraphicsCommandList());
 
-			flight_command_lists.push_back(&command_lists[i]);
+			flight_command_lists.push_back(command_lists[i]);
+		}
+
+		// unused, recycled with the submitted lists
+		if (pending_command_list)
+		{
+			pending_command_list->Close();
 			flight_command_lists.push_back(pending_command_list);
 		}
 
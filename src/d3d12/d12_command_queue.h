@@ -27,6 +27,8 @@ namespace light::rhi
 
 		uint64_t Signal() override;
 
+		void Wait(CommandQueue* queue, uint64_t fence_value) override;
+
 		bool IsFenceCompleted(uint64_t fence_value) override;
 
 		void WaitForFenceValue(uint64_t fence_value) override;
@@ -35,11 +37,13 @@ namespace light::rhi
 
 		uint64_t ExecuteCommandList(CommandList* command_list) override;
 
-		uint64_t ExecuteCommandLists(uint64_t num, CommandList* command_lists) override;
+		uint64_t ExecuteCommandLists(uint64_t num, CommandList* const* command_lists) override;
 
 		void ProcessCommandLists() override;
 
 		ID3D12CommandQueue* GetNative() { return queue_; }
+
+		ID3D12Fence* GetFence() { return fence_; }
 	private:
 		struct CommandListEntry
 		{
@@ -0,0 +1,35 @@
+#include "d12_command_signature.h"
+
+#include <cstddef>
+
+#include "d12_device.h"
+
+namespace light::rhi
+{
+	// the argument structs of the rhi are copied into argument buffers as is
+	static_assert(sizeof(DrawArguments) == sizeof(D3D12_DRAW_ARGUMENTS));
+	static_assert(offsetof(DrawArguments, instance_count) == offsetof(D3D12_DRAW_ARGUMENTS, InstanceCount));
+	static_assert(offsetof(DrawArguments, start_vertex) == offsetof(D3D12_DRAW_ARGUMENTS, StartVertexLocation));
+	static_assert(offsetof(DrawArguments, start_instance) == offsetof(D3D12_DRAW_ARGUMENTS, StartInstanceLocation));
+
+	static_assert(sizeof(DrawIndexedArguments) == sizeof(D3D12_DRAW_INDEXED_ARGUMENTS));
+	static_assert(offsetof(DrawIndexedArguments, instance_count) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS, InstanceCount));
+	static_assert(offsetof(DrawIndexedArguments, start_index) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS, StartIndexLocation));
+	static_assert(offsetof(DrawIndexedArguments, base_vertex) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS, BaseVertexLocation));
+	static_assert(offsetof(DrawIndexedArguments, start_instance) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS, StartInstanceLocation));
+
+	D12CommandSignature::D12CommandSignature(D12Device* device, D3D12_INDIRECT_ARGUMENT_TYPE type, uint32_t stride)
+		: stride_(stride)
+	{
+		D3D12_INDIRECT_ARGUMENT_DESC argument_desc{};
+		argument_desc.Type = type;
+
+		D3D12_COMMAND_SIGNATURE_DESC desc{};
+		desc.ByteStride = stride;
+		desc.NumArgumentDescs = 1;
+		desc.pArgumentDescs = &argument_desc;
+		desc.NodeMask = 0;
+
+		ThrowIfFailed(device->GetNative()->CreateCommandSignature(&desc, nullptr, IID_PPV_ARGS(&command_signature_)));
+	}
+}
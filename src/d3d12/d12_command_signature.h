@@ -0,0 +1,27 @@
+#pragma once
+
+#include <d3d12.h>
+
+#include "rhi/resource.h"
+
+namespace light::rhi
+{
+	class D12Device;
+
+	// Layout of the argument buffer entries consumed by ExecuteIndirect, one draw per entry and no root argument changes,
+	// so the signature needs no root signature and is shared by every pipeline
+	class D12CommandSignature final : public Resource
+	{
+	public:
+		D12CommandSignature(D12Device* device, D3D12_INDIRECT_ARGUMENT_TYPE type, uint32_t stride);
+
+		ID3D12CommandSignature* GetNative() { return command_signature_; }
+
+		uint32_t GetStride() const { return stride_; }
+	private:
+		Handle<ID3D12CommandSignature> command_signature_;
+		uint32_t stride_;
+	};
+
+	using D12CommandSignatureHandle = Handle<D12CommandSignature>;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "d12_descriptor_table.h"
+
+#include "d12_device.h"
+#include "d12_texture.h"
+
+namespace light::rhi
+{
+	D12DescriptorTable::D12DescriptorTable(D12Device* device, uint32_t num_descriptors)
+		: DescriptorTable(num_descriptors)
+		, device_(device)
+		, allocation_(device->AllocateGpuDescriptors(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, num_descriptors))
+		, resources_(num_descriptors)
+	{
+	}
+
+	void D12DescriptorTable::SetShaderResourceView(uint32_t index, Texture* texture, Format format, TextureDimension dimension,
+		uint32_t mip_level, uint32_t num_mip_levels, uint32_t array_slice, uint32_t num_array_slices)
+	{
+		auto d12_texture = CheckedCast<D12Texture*>(texture);
+		CopyDescriptor(index, texture, d12_texture->GetSRV(format, dimension, mip_level, num_mip_levels, array_slice, num_array_slices));
+	}
+
+	void D12DescriptorTable::SetUnorderedAccessView(uint32_t index, Texture* texture, Format format, TextureDimension dimension,
+		uint32_t mip_level, uint32_t array_slice, uint32_t num_array_slices)
+	{
+		auto d12_texture = CheckedCast<D12Texture*>(texture);
+		CopyDescriptor(index, texture, d12_texture->GetUAV(format, dimension, mip_level, array_slice, num_array_slices));
+	}
+
+	void D12DescriptorTable::SetStructuredBufferView(uint32_t index, Buffer* buffer, uint32_t offset, uint32_t byte_size)
+	{
+		auto d12_buffer = CheckedCast<D12Buffer*>(buffer);
+		CopyDescriptor(index, buffer, d12_buffer->GetSBV(offset, byte_size));
+	}
+
+	void D12DescriptorTable::SetUnoderedAccessBufferView(uint32_t index, Buffer* buffer, uint32_t offset, uint32_t byte_size)
+	{
+		auto d12_buffer = CheckedCast<D12Buffer*>(buffer);
+		CopyDescriptor(index, buffer, d12_buffer->GetUBV(offset, byte_size));
+	}
+
+	void D12DescriptorTable::CopyDescriptor(uint32_t index, Resource* resource, D3D12_CPU_DESCRIPTOR_HANDLE descriptor)
+	{
+		CHECK(index < num_descriptors_, "descriptor index out of the table");
+
+		device_->GetNative()->CopyDescriptorsSimple(1, allocation_.GetDescriptorHandle(index), descriptor, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+		resources_[index] = resource;
+	}
+}
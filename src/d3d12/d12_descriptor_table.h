@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include "rhi/descriptor_table.h"
+
+#include "descriptor_allocator.h"
+#include "d3dx12.h"
+
+namespace light::rhi
+{
+	class D12Device;
+
+	// Descriptors live in a page of the shader visible allocator, the views are copied in from the cpu only views of the resources
+	class D12DescriptorTable final : public DescriptorTable
+	{
+	public:
+		D12DescriptorTable(D12Device* device, uint32_t num_descriptors);
+
+		void SetShaderResourceView(uint32_t index, Texture* texture, Format format, TextureDimension dimension,
+			uint32_t mip_level, uint32_t num_mip_levels, uint32_t array_slice, uint32_t num_array_slices) override;
+
+		void SetUnorderedAccessView(uint32_t index, Texture* texture, Format format, TextureDimension dimension,
+			uint32_t mip_level, uint32_t array_slice, uint32_t num_array_slices) override;
+
+		void SetStructuredBufferView(uint32_t index, Buffer* buffer, uint32_t offset, uint32_t byte_size) override;
+
+		void SetUnoderedAccessBufferView(uint32_t index, Buffer* buffer, uint32_t offset, uint32_t byte_size) override;
+
+		ID3D12DescriptorHeap* GetDescriptorHeap() const { return allocation_.GetDescriptorHeap(); }
+
+		D3D12_GPU_DESCRIPTOR_HANDLE GetGpuDescriptorHandle() const { return allocation_.GetGpuDescriptorHandle(); }
+	private:
+		void CopyDescriptor(uint32_t index, Resource* resource, D3D12_CPU_DESCRIPTOR_HANDLE descriptor);
+
+		D12Device* device_;
+		DescriptorAllocation allocation_;
+
+		// the views don't hold their resources
+		std::vector<ResourceHandle> resources_;
+	};
+}
\ No newline at end of file
@@ -58,8 +58,8 @@ namespace light::rhi
 		}
 
 		queues_[static_cast<size_t>(CommandListType::kDirect)] = MakeHandle<D12CommandQueue>(this, CommandListType::kDirect);
-		/*queues_[static_cast<size_t>(CommandListType::kCompute)] = MakeHandle<D12CommandQueue>(this, CommandListType::kCompute);
-		queues_[static_cast<size_t>(CommandListType::kCopy)] = MakeHandle<D12CommandQueue>(this, CommandListType::kCopy);*/
+		queues_[static_cast<size_t>(CommandListType::kCompute)] = MakeHandle<D12CommandQueue>(this, CommandListType::kCompute);
+		queues_[static_cast<size_t>(CommandListType::kCopy)] = MakeHandle<D12CommandQueue>(this, CommandListType::kCopy);
 
 		ThrowIfFailed(device_->GetDeviceRemovedReason());
 
@@ -68,6 +68,14 @@ namespace light::rhi
 			descriptor_allocators_[i] = 
 				std::make_unique<DescriptorAllocator>(this, static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(i));
 		}
+
+		// one page holds the baked tables and the dynamic blocks of the command lists, every page is its own heap
+		// and a table or block of another page switches the heap of the command list. samplers are capped at 2048
+		gpu_descriptor_allocators_[D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV] = std::make_unique<DescriptorAllocator>(this, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 65536, true);
+		gpu_descriptor_allocators_[D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER] = std::make_unique<DescriptorAllocator>(this, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER, 2048, true);
+
+		draw_command_signature_ = MakeHandle<D12CommandSignature>(this, D3D12_INDIRECT_ARGUMENT_TYPE_DRAW, sizeof(DrawArguments));
+		draw_indexed_command_signature_ = MakeHandle<D12CommandSignature>(this, D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED, sizeof(DrawIndexedArguments));
 	}
 
 	D12Device::~D12Device()
@@ -127,6 +135,11 @@ namespace light::rhi
 		return tex;
 	}
 
+	DescriptorTableHandle D12Device::CreateDescriptorTable(uint32_t num_descriptors)
+	{
+		return MakeHandle<D12DescriptorTable>(this, num_descriptors);
+	}
+
 	InputLayoutHandle D12Device::CreateInputLayout(std::vector<VertexAttributeDesc> attributes)
 	{
 		return MakeHandle<D12InputLayout>(this, std::move(attributes));
@@ -167,6 +180,12 @@ namespace light::rhi
 		return descriptor_allocators_[type]->Allocate(num_descriptors);
 	}
 
+	DescriptorAllocation D12Device::AllocateGpuDescriptors(D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t num_descriptors)
+	{
+		CHECK(type <= D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER, "rtv and dsv heaps can't be shader visible");
+		return gpu_descriptor_allocators_[type]->Allocate(num_descriptors);
+	}
+
 	void D12Device::Flush()
 	{
 		for(auto queue : queues_)
@@ -192,6 +211,11 @@ namespace light::rhi
 		{
 			descriptor_allocator->ReleaseStaleDescriptors();
 		}
+
+		for (auto& gpu_descriptor_allocator : gpu_descriptor_allocators_)
+		{
+			gpu_descriptor_allocator->ReleaseStaleDescriptors();
+		}
 	}
 
 	uint32_t D12Device::GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE type) const
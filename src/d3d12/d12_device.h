@@ -7,7 +7,9 @@
 #include "d12_convert.h"
 #include "d12_command_list.h"
 #include "d12_command_queue.h"
+#include "d12_command_signature.h"
 #include "d12_buffer.h"
+#include "d12_descriptor_table.h"
 #include "d12_input_layout.h"
 #include "d12_graphics_pipeline.h"
 #include "d12_swap_chain.h"
@@ -53,6 +55,8 @@ namespace light::rhi
 
 		GraphicsPipelineHandle CreateGraphicsPipeline(GraphicsPipelineDesc desc, const RenderTarget& render_target) override;
 
+		DescriptorTableHandle CreateDescriptorTable(uint32_t num_descriptors) override;
+
 		CommandQueue* GetCommandQueue(CommandListType type) override;
 
 		CommandListHandle GetCommandList(CommandListType type) override;
@@ -65,17 +69,28 @@ namespace light::rhi
 
 		DescriptorAllocation AllocateDescriptors(D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t num_descriptors);
 
+		// contiguous cbv/srv/uav or sampler descriptors in a shader visible heap, shared by the baked descriptor tables
+		// and the dynamic descriptor heaps of the command lists
+		DescriptorAllocation AllocateGpuDescriptors(D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t num_descriptors);
+
 
 		void ReleaseRootSignature(const RootSignature* root_signature);
 
 		void ReleaseStaleDescriptors();
 
 		uint32_t GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE type) const;
+
+		D12CommandSignature* GetDrawCommandSignature() { return draw_command_signature_; }
+
+		D12CommandSignature* GetDrawIndexedCommandSignature() { return draw_indexed_command_signature_; }
 	private:
 		Handle<ID3D12Device> device_;
 		Microsoft::WRL::ComPtr<IDXGIFactory5> dxgi_factory_;
 		std::array<Handle<D12CommandQueue>, static_cast<size_t>(CommandListType::kCopy) + 1> queues_;
 		std::unordered_map<size_t, RootSignature*> root_signature_cache_;
 		std::array<std::unique_ptr<DescriptorAllocator>, D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES> descriptor_allocators_;
+		std::array<std::unique_ptr<DescriptorAllocator>, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER + 1> gpu_descriptor_allocators_;
+		D12CommandSignatureHandle draw_command_signature_;
+		D12CommandSignatureHandle draw_indexed_command_signature_;
 	};
 }
\ No newline at end of file
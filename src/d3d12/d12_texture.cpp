@@ -29,6 +29,8 @@ namespace light::rhi
 
 	D3D12_CPU_DESCRIPTOR_HANDLE D12Texture::GetRTV()
 	{
+		std::lock_guard<std::mutex> lock(view_mutex_);
+
 		size_t hash = 0;
 
 		auto it = rtv_map_.find(hash);
@@ -47,6 +49,8 @@ namespace light::rhi
 
 	D3D12_CPU_DESCRIPTOR_HANDLE D12Texture::GetRTV(Format format, uint32_t mip_level, uint32_t array_slice, uint32_t num_array_slices)
 	{
+		std::lock_guard<std::mutex> lock(view_mutex_);
+
 		format = format == Format::UNKNOWN ? desc_.format : format;
 
 		size_t hash = 0;
@@ -122,6 +126,8 @@ namespace light::rhi
 
 	D3D12_CPU_DESCRIPTOR_HANDLE D12Texture::GetDSV()
 	{
+		std::lock_guard<std::mutex> lock(view_mutex_);
+
 		size_t hash = 0;
 
 		auto it = dsv_map_.find(hash);
@@ -140,6 +146,8 @@ namespace light::rhi
 
 	D3D12_CPU_DESCRIPTOR_HANDLE D12Texture::GetDSV(uint32_t mip_level, uint32_t array_slice, uint32_t num_array_slices)
 	{
+		std::lock_guard<std::mutex> lock(view_mutex_);
+
 		size_t hash = 0;
 
 		HashCombine(hash, mip_level);
@@ -206,6 +214,8 @@ namespace light::rhi
 	D3D12_CPU_DESCRIPTOR_HANDLE D12Texture::GetSRV(Format format, TextureDimension dimension, uint32_t mip_level, uint32_t num_mip_levels, uint32_t array_slice,
 		uint32_t num_array_slices)
 	{
+		std::lock_guard<std::mutex> lock(view_mutex_);
+
 		format = format == Format::UNKNOWN ? desc_.format : format;
 
 		size_t hash = 0;
@@ -297,4 +307,81 @@ namespace light::rhi
 
 		return handle;
 	}
+
+	D3D12_CPU_DESCRIPTOR_HANDLE D12Texture::GetUAV(Format format, TextureDimension dimension, uint32_t mip_level, uint32_t array_slice,
+		uint32_t num_array_slices)
+	{
+		std::lock_guard<std::mutex> lock(view_mutex_);
+
+		format = format == Format::UNKNOWN ? desc_.format : format;
+		num_array_slices = num_array_slices == ~0u ? desc_.array_size - array_slice : num_array_slices;
+
+		size_t hash = 0;
+
+		HashCombine(hash, static_cast<uint8_t>(format));
+		HashCombine(hash, static_cast<uint8_t>(dimension));
+		HashCombine(hash, mip_level);
+		HashCombine(hash, array_slice);
+		HashCombine(hash, num_array_slices);
+
+		auto it = uav_map_.find(hash);
+		if (it != uav_map_.end())
+		{
+			return it->second.GetDescriptorHandle();
+		}
+
+		D3D12_UNORDERED_ACCESS_VIEW_DESC uav_desc{};
+		uav_desc.Format = GetDxgiFormatMapping(format).srv_format;
+
+		switch (dimension) {
+		case TextureDimension::kTexture1D:
+			uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE1D;
+			uav_desc.Texture1D.MipSlice = mip_level;
+			break;
+
+		case TextureDimension::kTexture1DArray:
+			uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE1DARRAY;
+			uav_desc.Texture1DArray.MipSlice = mip_level;
+			uav_desc.Texture1DArray.FirstArraySlice = array_slice;
+			uav_desc.Texture1DArray.ArraySize = num_array_slices;
+			break;
+
+		case TextureDimension::kTexture2D:
+			uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+			uav_desc.Texture2D.MipSlice = mip_level;
+			uav_desc.Texture2D.PlaneSlice = 0;
+			break;
+
+		case TextureDimension::kTexture2DArray:
+		case TextureDimension::kTextureCube:
+		case TextureDimension::kTextureCubeArray:
+			// cubes are written as arrays of faces
+			uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2DARRAY;
+			uav_desc.Texture2DArray.MipSlice = mip_level;
+			uav_desc.Texture2DArray.FirstArraySlice = array_slice;
+			uav_desc.Texture2DArray.ArraySize = num_array_slices;
+			uav_desc.Texture2DArray.PlaneSlice = 0;
+			break;
+
+		case TextureDimension::kTexture3D:
+			uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE3D;
+			uav_desc.Texture3D.MipSlice = mip_level;
+			uav_desc.Texture3D.FirstWSlice = 0;
+			uav_desc.Texture3D.WSize = -1;
+			break;
+
+		case TextureDimension::kTexture2DMS:
+		case TextureDimension::kTexture2DMSArray:
+		case TextureDimension::kUnknown:
+		default:
+			assert(false);
+		}
+
+		DescriptorAllocation allocation = device_->AllocateDescriptors(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 1);
+		D3D12_CPU_DESCRIPTOR_HANDLE handle = allocation.GetDescriptorHandle();
+		device_->GetNative()->CreateUnorderedAccessView(resource_, nullptr, &uav_desc, handle);
+		uav_map_.emplace(hash, std::move(allocation));
+
+		return handle;
+	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <mutex>
 
 #include "rhi/types.h"
 #include "rhi/texture.h"
@@ -24,6 +25,7 @@ namespace light::rhi
 		D3D12_CPU_DESCRIPTOR_HANDLE GetDSV();
 		D3D12_CPU_DESCRIPTOR_HANDLE GetDSV(uint32_t mip_level, uint32_t array_slice, uint32_t num_array_slices);
 		D3D12_CPU_DESCRIPTOR_HANDLE GetSRV(Format format,TextureDimension dimension, uint32_t mip_level,uint32_t num_mip_levels, uint32_t array_slice, uint32_t num_array_slices);
+		D3D12_CPU_DESCRIPTOR_HANDLE GetUAV(Format format, TextureDimension dimension, uint32_t mip_level, uint32_t array_slice, uint32_t num_array_slices);
 
 		ID3D12Resource* GetNative() { return resource_; }
 	private:
@@ -33,5 +35,9 @@ namespace light::rhi
 		std::unordered_map<size_t, DescriptorAllocation> rtv_map_;
 		std::unordered_map<size_t, DescriptorAllocation> dsv_map_;
 		std::unordered_map<size_t, DescriptorAllocation> srv_map_;
+		std::unordered_map<size_t, DescriptorAllocation> uav_map_;
+
+		// views are created lazily, possibly from several recording threads
+		std::mutex view_mutex_;
 	};
 }
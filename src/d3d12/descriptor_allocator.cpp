@@ -76,6 +76,16 @@ namespace light::rhi
 		return CD3DX12_CPU_DESCRIPTOR_HANDLE(descriptor_, static_cast<INT>(offset * descriptor_size_));
 	}
 
+	D3D12_GPU_DESCRIPTOR_HANDLE DescriptorAllocation::GetGpuDescriptorHandle(uint32_t offset) const
+	{
+		return CD3DX12_GPU_DESCRIPTOR_HANDLE(page_->GetGpuDescriptorHandle(descriptor_), static_cast<INT>(offset * descriptor_size_));
+	}
+
+	ID3D12DescriptorHeap* DescriptorAllocation::GetDescriptorHeap() const
+	{
+		return page_ ? page_->GetDescriptorHeap() : nullptr;
+	}
+
 	uint32_t DescriptorAllocation::GetNumHandles() const
 	{
 		return num_handles_;
@@ -165,18 +175,24 @@ namespace light::rhi
 	}
 
 	DescriptorAllocatorPage::DescriptorAllocatorPage(D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type,
-		uint32_t num_descriptors)
+		uint32_t num_descriptors, bool shader_visible)
 			: device_(device)
 			, heap_type_(type)
+		, base_gpu_descriptor_(D3D12_DEFAULT)
 		, num_descriptors_(num_descriptors)
 	{
 		D3D12_DESCRIPTOR_HEAP_DESC heap_desc{};
 		heap_desc.Type = heap_type_;
 		heap_desc.NumDescriptors = num_descriptors_;
+		heap_desc.Flags = shader_visible ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE : D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
 
 		ThrowIfFailed(device->GetNative()->CreateDescriptorHeap(&heap_desc, IID_PPV_ARGS(&d3d12_descriptor_heap_)));
 
 		base_descriptor_ = d3d12_descriptor_heap_->GetCPUDescriptorHandleForHeapStart();
+		if (shader_visible)
+		{
+			base_gpu_descriptor_ = d3d12_descriptor_heap_->GetGPUDescriptorHandleForHeapStart();
+		}
 		descriptor_handle_increment_size_ = device_->GetDescriptorHandleIncrementSize(type);
 		num_free_handles_ = num_descriptors_;
 
@@ -184,11 +200,16 @@ namespace light::rhi
 		AddNewBlock(0, num_descriptors_);
 	}
 
-	uint32_t DescriptorAllocatorPage::ComputeOffset(D3D12_CPU_DESCRIPTOR_HANDLE handle)
+	uint32_t DescriptorAllocatorPage::ComputeOffset(D3D12_CPU_DESCRIPTOR_HANDLE handle) const
 	{
 		return (handle.ptr - base_descriptor_.ptr) / descriptor_handle_increment_size_;
 	}
 
+	D3D12_GPU_DESCRIPTOR_HANDLE DescriptorAllocatorPage::GetGpuDescriptorHandle(D3D12_CPU_DESCRIPTOR_HANDLE handle) const
+	{
+		return CD3DX12_GPU_DESCRIPTOR_HANDLE(base_gpu_descriptor_, ComputeOffset(handle), descriptor_handle_increment_size_);
+	}
+
 	void DescriptorAllocatorPage::AddNewBlock(uint32_t offset, uint32_t num_descriptors)
 	{
 		auto it = free_list_.find(num_descriptors);
@@ -256,10 +277,11 @@ namespace light::rhi
 		AddNewBlock(new_offset, new_num_descriptors);
 	}
 
-	DescriptorAllocator::DescriptorAllocator(D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t page_size)
+	DescriptorAllocator::DescriptorAllocator(D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t page_size, bool shader_visible)
 		: device_(device)
 		, heap_type_(type)
 		, page_size_(page_size)
+		, shader_visible_(shader_visible)
 	{
 	}
 
@@ -322,7 +344,7 @@ namespace light::rhi
 
 	DescriptorAllocatorPage* DescriptorAllocator::CreateAllocatorPage()
 	{
-		auto page = std::make_unique<DescriptorAllocatorPage>(device_, heap_type_, page_size_);
+		auto page = std::make_unique<DescriptorAllocatorPage>(device_, heap_type_, page_size_, shader_visible_);
 		pages_.push_back(std::move(page));
 
 		available_pages_.insert(pages_.size() - 1);
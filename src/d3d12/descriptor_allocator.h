@@ -46,6 +46,11 @@ namespace light::rhi
 
 		D3D12_CPU_DESCRIPTOR_HANDLE GetDescriptorHandle(uint32_t offset = 0) const;
 
+		// only valid for allocations of a shader visible allocator
+		D3D12_GPU_DESCRIPTOR_HANDLE GetGpuDescriptorHandle(uint32_t offset = 0) const;
+
+		ID3D12DescriptorHeap* GetDescriptorHeap() const;
+
 		uint32_t GetNumHandles() const;
 	private:
 		void Free();
@@ -61,6 +66,10 @@ namespace light::rhi
 	public:
 		D3D12_DESCRIPTOR_HEAP_TYPE GetHeapType() const { return heap_type_; }
 
+		ID3D12DescriptorHeap* GetDescriptorHeap() const { return d3d12_descriptor_heap_; }
+
+		D3D12_GPU_DESCRIPTOR_HANDLE GetGpuDescriptorHandle(D3D12_CPU_DESCRIPTOR_HANDLE handle) const;
+
 		// Ƿʣ
 		bool HasSpace(uint32_t num_descriptors) const;
 
@@ -72,10 +81,10 @@ namespace light::rhi
 
 		void ReleaseStaleDescriptors();
 
-		DescriptorAllocatorPage(D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t num_descriptors);
+		DescriptorAllocatorPage(D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t num_descriptors, bool shader_visible = false);
 
 		// HandleHeapʼλõƫ
-		uint32_t ComputeOffset(D3D12_CPU_DESCRIPTOR_HANDLE handle);
+		uint32_t ComputeOffset(D3D12_CPU_DESCRIPTOR_HANDLE handle) const;
 
 		// FreeList
 		void AddNewBlock(uint32_t offset, uint32_t num_descriptors);
@@ -122,6 +131,7 @@ namespace light::rhi
 		D3D12_DESCRIPTOR_HEAP_TYPE heap_type_;
 		Handle<ID3D12DescriptorHeap> d3d12_descriptor_heap_;
 		CD3DX12_CPU_DESCRIPTOR_HANDLE base_descriptor_;
+		CD3DX12_GPU_DESCRIPTOR_HANDLE base_gpu_descriptor_;
 		uint32_t descriptor_handle_increment_size_;
 		uint32_t num_descriptors_;
 		uint32_t num_free_handles_;
@@ -135,7 +145,8 @@ namespace light::rhi
 	class DescriptorAllocator
 	{
 	public:
-		DescriptorAllocator(D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t page_size = 256);
+		// shader visible pages are separate heaps, binding descriptors of another page switches the heap of the command list
+		DescriptorAllocator(D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t page_size = 256, bool shader_visible = false);
 		~DescriptorAllocator();
 		
 		DescriptorAllocation Allocate(uint32_t num_descriptors = 1);
@@ -147,6 +158,7 @@ namespace light::rhi
 		D12Device* device_;
 		D3D12_DESCRIPTOR_HEAP_TYPE heap_type_;
 		uint32_t page_size_;
+		bool shader_visible_;
 
 		std::vector<std::unique_ptr<DescriptorAllocatorPage>> pages_;
 		std::set<size_t> available_pages_;
@@ -1,6 +1,7 @@
 #include "dynamic_descriptor_heap.h"
 
 #include "d12_device.h"
+#include "d12_command_list.h"
 
 namespace light::rhi
 {
@@ -11,6 +12,8 @@ namespace light::rhi
 		, heap_size_(heap_size)
 		, descriptor_table_bit_mask_(0)
 		, stale_descriptor_table_bit_mask_(0)
+		, staged_descriptor_table_bit_mask_(0)
+		, num_used_descriptor_blocks_(0)
 		, current_descriptor_heap_(nullptr)
 		, current_gpu_descriptor_handle_(D3D12_DEFAULT)
 		, current_cpu_descriptor_handle_(D3D12_DEFAULT)
@@ -49,24 +52,13 @@ namespace light::rhi
 
 		// Ҫµλ
 		stale_descriptor_table_bit_mask_ |= (1 << parameter_index);
+		staged_descriptor_table_bit_mask_ |= (1 << parameter_index);
 	}
 
 	D3D12_GPU_DESCRIPTOR_HANDLE DynamicDescriptorHeap::CopyDescriptor(D12CommandList* command_list,
 		D3D12_CPU_DESCRIPTOR_HANDLE cpu_descriptor)
 	{
-		// ǷҪµĶ
-		if (!current_descriptor_heap_ || num_free_handles_ < 1)
-		{
-			current_descriptor_heap_ = RequestDescriptorHeap();
-			current_cpu_descriptor_handle_ = current_descriptor_heap_->GetCPUDescriptorHandleForHeapStart();
-			current_gpu_descriptor_handle_ = current_descriptor_heap_->GetGPUDescriptorHandleForHeapStart();
-
-			command_list->SetDescriptorHeap(heap_type_, current_descriptor_heap_);
-
-			// current_descriptor_heap_ºҪ
-			// Ҫstale_descriptor_table_bit_mask_Ϊdescriptor_table_bit_mask_
-			stale_descriptor_table_bit_mask_ = descriptor_table_bit_mask_;
-		}
+		PrepareDescriptorHeap(command_list, 1);
 
 		device_->GetNative()->CopyDescriptorsSimple(1, current_cpu_descriptor_handle_, cpu_descriptor, heap_type_);
 
@@ -81,7 +73,11 @@ namespace light::rhi
 
 	void DynamicDescriptorHeap::CommitStatedDescriptorsForDraw(D12CommandList* command_list)
 	{
-		CommitDescriptorTables(command_list, &ID3D12GraphicsCommandList::SetGraphicsRootDescriptorTable);
+		// through the command list, it skips a baked table bound to the same parameter afterwards only if it is still bound
+		CommitDescriptorTables(command_list, [command_list](ID3D12GraphicsCommandList*, UINT parameter_index, D3D12_GPU_DESCRIPTOR_HANDLE descriptor)
+			{
+				command_list->SetGraphicsRootDescriptorTable(parameter_index, descriptor);
+			});
 	}
 
 	void DynamicDescriptorHeap::CommitStatedDescriptorsForCompute(D12CommandList* command_list)
@@ -95,6 +91,7 @@ namespace light::rhi
 
 		// root signatureı䣬еҪ°
 		stale_descriptor_table_bit_mask_ = 0;
+		staged_descriptor_table_bit_mask_ = 0;
 
 		if(heap_type_ == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)
 		{
@@ -126,7 +123,7 @@ namespace light::rhi
 
 	void DynamicDescriptorHeap::Rest()
 	{
-		available_descriptor_heaps_ = descriptor_heap_pool_;
+		num_used_descriptor_blocks_ = 0;
 
 		current_descriptor_heap_ = nullptr;
 		current_cpu_descriptor_handle_ = CD3DX12_CPU_DESCRIPTOR_HANDLE(D3D12_DEFAULT);
@@ -134,6 +131,7 @@ namespace light::rhi
 
 		descriptor_table_bit_mask_ = 0;
 		stale_descriptor_table_bit_mask_ = 0;
+		staged_descriptor_table_bit_mask_ = 0;
 		num_free_handles_ = 0;
 
 		for (size_t i = 0; i < kMaxDescriptorTables; ++i)
@@ -142,42 +140,55 @@ namespace light::rhi
 		}
 	}
 
-	ID3D12DescriptorHeap* DynamicDescriptorHeap::RequestDescriptorHeap()
+	void DynamicDescriptorHeap::UnstageDescriptorTable(uint32_t parameter_index)
 	{
-		if(available_descriptor_heaps_.empty())
+		stale_descriptor_table_bit_mask_ &= ~(1 << parameter_index);
+		staged_descriptor_table_bit_mask_ &= ~(1 << parameter_index);
+	}
+
+	void DynamicDescriptorHeap::PrepareDescriptorHeap(D12CommandList* command_list, uint32_t num_descriptors)
+	{
+		if (!current_descriptor_heap_ || num_free_handles_ < num_descriptors)
 		{
-			auto heap = CreateDescriptorHeap();
-			descriptor_heap_pool_.push(heap);
-			return heap;
+			const auto& block = RequestDescriptorBlock();
+			current_descriptor_heap_ = block.GetDescriptorHeap();
+			current_cpu_descriptor_handle_ = block.GetDescriptorHandle();
+			current_gpu_descriptor_handle_ = block.GetGpuDescriptorHandle();
+			num_free_handles_ = heap_size_;
+
+			// the staged tables point into the previous block
+			stale_descriptor_table_bit_mask_ = staged_descriptor_table_bit_mask_;
 		}
-		else
+
+		if (command_list->GetDescriptorHeap(heap_type_) != current_descriptor_heap_)
 		{
-			auto heap = available_descriptor_heaps_.front();
-			available_descriptor_heaps_.pop();
-			return heap;
+			command_list->SetDescriptorHeap(heap_type_, current_descriptor_heap_);
+			command_list->CommitDescriptorHeaps();
+
+			stale_descriptor_table_bit_mask_ = staged_descriptor_table_bit_mask_;
 		}
 	}
 
-	Handle<ID3D12DescriptorHeap> DynamicDescriptorHeap::CreateDescriptorHeap()
+	const DescriptorAllocation& DynamicDescriptorHeap::RequestDescriptorBlock()
 	{
-		Handle<ID3D12DescriptorHeap> heap;
-
-		D3D12_DESCRIPTOR_HEAP_DESC desc{};
-		desc.Type = heap_type_;
-		desc.NumDescriptors = heap_size_;
-		desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-
-		device_->GetNative()->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&heap));
+		if (num_used_descriptor_blocks_ == descriptor_blocks_.size())
+		{
+			descriptor_blocks_.push_back(device_->AllocateGpuDescriptors(heap_type_, heap_size_));
+		}
 
-		return heap;
+		return descriptor_blocks_[num_used_descriptor_blocks_++];
 	}
 
 	uint32_t DynamicDescriptorHeap::ComputeStaleDescriptorCount() const
 	{
+		// a new block recommits every staged table
 		uint32_t num_descriptors = 0;
 		for (size_t i = 0; i < kMaxDescriptorTables; ++i)
 		{
-			num_descriptors += descriptor_table_cache_[i].num_descriptors;
+			if (staged_descriptor_table_bit_mask_ & (1 << i))
+			{
+				num_descriptors += descriptor_table_cache_[i].num_descriptors;
+			}
 		}
 
 		return num_descriptors;
@@ -186,22 +197,13 @@ namespace light::rhi
 	void DynamicDescriptorHeap::CommitDescriptorTables(D12CommandList* command_list,
 		std::function<void(ID3D12GraphicsCommandList*, UINT, D3D12_GPU_DESCRIPTOR_HANDLE)> set_func)
 	{
-		uint32_t num_descriptors = ComputeStaleDescriptorCount();
-
-		// ǷҪµĶ
-		if(!current_descriptor_heap_ || num_free_handles_ < num_descriptors)
+		if (!stale_descriptor_table_bit_mask_)
 		{
-			current_descriptor_heap_ = RequestDescriptorHeap();
-			current_cpu_descriptor_handle_ = current_descriptor_heap_->GetCPUDescriptorHandleForHeapStart();
-			current_gpu_descriptor_handle_ = current_descriptor_heap_->GetGPUDescriptorHandleForHeapStart();
-
-			command_list->SetDescriptorHeap(heap_type_, current_descriptor_heap_);
-
-			// current_descriptor_heap_ºҪ
-			// Ҫstale_descirptor_table_bit_mask_Ϊdescriptor_table_bit_mask_
-			stale_descriptor_table_bit_mask_ = descriptor_table_bit_mask_;
+			return;
 		}
 
+		PrepareDescriptorHeap(command_list, ComputeStaleDescriptorCount());
+
 		DWORD index = 0;
 		while(_BitScanForward(&index,stale_descriptor_table_bit_mask_))
 		{
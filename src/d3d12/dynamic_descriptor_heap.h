@@ -6,6 +6,7 @@
 
 #include "rhi/resource.h"
 
+#include "descriptor_allocator.h"
 #include "d3dx12.h"
 
 
@@ -15,6 +16,8 @@ namespace light::rhi
 	class D12CommandList;
 	class RootSignature;
 
+	// Stages cpu descriptors and copies them into blocks of the shader visible heap of the device when a draw
+	// commits them. The blocks share that heap with the baked descriptor tables, so binding both keeps one heap set
 	class DynamicDescriptorHeap
 	{
 	public:
@@ -33,11 +36,16 @@ namespace light::rhi
 
 		void ParseRootSignature(const RootSignature* root_signature);
 
+		// a baked descriptor table is bound to the parameter, the staged descriptors of it are no longer committed
+		void UnstageDescriptorTable(uint32_t parameter_index);
+
 		void Rest();
 	private:
-		ID3D12DescriptorHeap* RequestDescriptorHeap();
+		// a block with num_descriptors free handles whose heap is set on the command list. a heap switch,
+		// by another block or a baked table of another page, leaves the tables bound before undefined
+		void PrepareDescriptorHeap(D12CommandList* command_list, uint32_t num_descriptors);
 
-		Handle<ID3D12DescriptorHeap> CreateDescriptorHeap();
+		const DescriptorAllocation& RequestDescriptorBlock();
 
 		// ҪύGPUɼѵ
 		uint32_t ComputeStaleDescriptorCount() const;
@@ -85,8 +93,12 @@ namespace light::rhi
 		// Ҫĸµroot signatureĸ
 		uint32_t stale_descriptor_table_bit_mask_;
 
-		std::queue<Handle<ID3D12DescriptorHeap>> descriptor_heap_pool_;
-		std::queue<Handle<ID3D12DescriptorHeap>> available_descriptor_heaps_;
+		// parameters with staged descriptors since the root signature was parsed, recommitted after a heap switch
+		uint32_t staged_descriptor_table_bit_mask_;
+
+		// blocks of heap_size_ descriptors, the used ones are handed out again after Rest
+		std::vector<DescriptorAllocation> descriptor_blocks_;
+		size_t num_used_descriptor_blocks_;
 
 		ID3D12DescriptorHeap* current_descriptor_heap_;
 		CD3DX12_GPU_DESCRIPTOR_HANDLE current_gpu_descriptor_handle_;
@@ -70,6 +70,34 @@ namespace light::rhi
 		}
 	}
 
+	void ResourceStateTracker::ExplicitBarrier(const D3D12_RESOURCE_BARRIER& barrier)
+	{
+		resource_barriers_.push_back(barrier);
+	}
+
+	bool ResourceStateTracker::GetFinalState(ID3D12Resource* resource, UINT subresource, D3D12_RESOURCE_STATES& state) const
+	{
+		auto it = final_resource_state_.find(resource);
+		if (it == final_resource_state_.end())
+		{
+			return false;
+		}
+
+		// subresources in different states have no single state
+		if (subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES && !it->second.subresource_state.empty())
+		{
+			return false;
+		}
+
+		state = it->second.GetSubresourceState(subresource);
+		return true;
+	}
+
+	void ResourceStateTracker::SetFinalState(ID3D12Resource* resource, UINT subresource, D3D12_RESOURCE_STATES state)
+	{
+		final_resource_state_[resource].SetSubresourceState(subresource, state);
+	}
+
 	void ResourceStateTracker::FlushResourceBarriers(D12CommandList* command_list)
 	{
 		if(resource_barriers_.empty())
@@ -157,4 +185,4 @@ namespace light::rhi
 		std::unique_lock<std::mutex> lock(s_global_mutex);
 		s_global_resource_state_[resource].SetSubresourceState(D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, state);
 	}
-}
+}
\ No newline at end of file
@@ -36,6 +36,15 @@ namespace light::rhi
 
 		void ResourceBarrier(const D3D12_RESOURCE_BARRIER& barrier);
 
+		// Barrier whose states are already known, bypasses the state lookups
+		void ExplicitBarrier(const D3D12_RESOURCE_BARRIER& barrier);
+
+		// State the command list left the resource in, false if it was not used by the list yet
+		bool GetFinalState(ID3D12Resource* resource, UINT subresource, D3D12_RESOURCE_STATES& state) const;
+
+		// Records the state after an explicit barrier, e.g. the end of a split barrier
+		void SetFinalState(ID3D12Resource* resource, UINT subresource, D3D12_RESOURCE_STATES state);
+
 		void FlushResourceBarriers(D12CommandList* command_list);
 
 		uint32_t FlushPendingResourceBarriers(D12CommandList* command_list);
@@ -90,4 +99,4 @@ namespace light::rhi
 		static ResourceStateMap s_global_resource_state_;
 
 	};
-}
+}
\ No newline at end of file
@@ -0,0 +1,258 @@
+#include "rhi/render_queue.h"
+
+#include <algorithm>
+#include <array>
+#include <future>
+#include <thread>
+
+namespace light::rhi
+{
+	namespace
+	{
+		constexpr uint32_t kRadixBits = 8;
+		constexpr uint32_t kRadix = 1u << kRadixBits;
+
+		// below this many entries per thread the fork join costs more than the sort
+		constexpr size_t kMinEntriesPerSortThread = 16 * 1024;
+
+		constexpr uint32_t kLayoutBits = 8;
+		constexpr uint32_t kPipelineBits = 12;
+		constexpr uint32_t kMaterialBits = 12;
+		constexpr uint32_t kBufferBits = 12;
+		constexpr uint32_t kDepthBits = 20;
+
+		// top bits of a mixed pointer, equal objects get equal bits, unequal ones collide rarely and only cost a rebind
+		uint64_t PointerBits(const void* pointer, uint32_t num_bits)
+		{
+			uint64_t value = reinterpret_cast<uintptr_t>(pointer);
+			value ^= value >> 33;
+			value *= 0xff51afd7ed558ccdull;
+			value ^= value >> 33;
+			return value >> (64 - num_bits);
+		}
+
+		template<typename Function>
+		void ParallelFor(uint32_t num_threads, Function&& function)
+		{
+			std::vector<std::future<void>> futures;
+			futures.reserve(num_threads);
+			for (uint32_t thread = 1; thread < num_threads; ++thread)
+			{
+				futures.push_back(std::async(std::launch::async, function, thread));
+			}
+
+			function(0);
+
+			for (auto& future : futures)
+			{
+				future.get();
+			}
+		}
+	}
+
+	RenderQueue::RenderQueue(uint32_t num_buckets)
+		: buckets_(std::max(num_buckets, 1u))
+	{
+	}
+
+	void RenderQueue::Submit(uint32_t bucket, const DrawItem& item, float depth)
+	{
+		CHECK(bucket < buckets_.size(), "bucket out of range");
+		CHECK(item.pipeline, "draw items need a pipeline");
+
+		auto& target = buckets_[bucket];
+		target.keys.push_back(ComputeDrawKey(item, depth));
+		target.constant_offsets.push_back(static_cast<uint32_t>(target.constants.size()));
+
+		auto* constants = static_cast<const uint32_t*>(item.constants);
+		target.constants.insert(target.constants.end(), constants, constants + item.num_constants);
+
+		target.items.emplace_back(item).constants = nullptr;
+	}
+
+	void RenderQueue::Flush(CommandList* command_list)
+	{
+		pipeline_keys_.clear();
+		layout_ids_.clear();
+		material_keys_.clear();
+
+		entries_.clear();
+		entries_.reserve(GetNumItems());
+		for (uint32_t i = 0; i < buckets_.size(); ++i)
+		{
+			const auto& bucket = buckets_[i];
+			for (uint32_t j = 0; j < bucket.items.size(); ++j)
+			{
+				const auto& item = bucket.items[j];
+				entries_.push_back({ bucket.keys[j] | GetPipelineKey(item.pipeline) | GetMaterialKey(item.descriptor_table), i, j });
+			}
+		}
+
+		Sort();
+
+		const DrawItem* previous = nullptr;
+		for (const auto& entry : entries_)
+		{
+			const auto& bucket = buckets_[entry.bucket];
+			const auto& item = bucket.items[entry.item];
+
+			bool pipeline_changed = !previous || previous->pipeline != item.pipeline;
+			if (pipeline_changed)
+			{
+				command_list->SetGraphicsPipeline(item.pipeline);
+			}
+
+			if (!previous || previous->primitive_topology != item.primitive_topology)
+			{
+				command_list->SetPrimitiveTopology(item.primitive_topology);
+			}
+
+			if (item.vertex_buffer && (!previous || previous->vertex_buffer != item.vertex_buffer))
+			{
+				command_list->SetVertexBuffer(0, item.vertex_buffer);
+			}
+
+			if (item.index_buffer && (!previous || previous->index_buffer != item.index_buffer))
+			{
+				command_list->SetIndexBuffer(item.index_buffer);
+			}
+
+			// a pipeline with another binding layout drops the bound root parameters, the command list skips the bind if it did not
+			if (item.descriptor_table && (pipeline_changed
+				|| previous->descriptor_table != item.descriptor_table
+				|| previous->descriptor_table_parameter != item.descriptor_table_parameter))
+			{
+				command_list->SetGraphicsDescriptorTable(item.descriptor_table_parameter, item.descriptor_table);
+			}
+
+			if (item.num_constants)
+			{
+				command_list->SetGraphics32BitConstants(item.constants_parameter, item.num_constants,
+					bucket.constants.data() + bucket.constant_offsets[entry.item]);
+			}
+
+			command_list->DrawIndexed(item.index_count, item.instance_count, item.start_index, item.base_vertex, item.start_instance);
+
+			previous = &item;
+		}
+
+		for (auto& bucket : buckets_)
+		{
+			bucket.items.clear();
+			bucket.keys.clear();
+			bucket.constant_offsets.clear();
+			bucket.constants.clear();
+		}
+	}
+
+	uint32_t RenderQueue::GetNumItems() const
+	{
+		size_t num_items = 0;
+		for (const auto& bucket : buckets_)
+		{
+			num_items += bucket.items.size();
+		}
+		return static_cast<uint32_t>(num_items);
+	}
+
+	uint64_t RenderQueue::ComputeDrawKey(const DrawItem& item, float depth)
+	{
+		uint64_t buffers = reinterpret_cast<uintptr_t>(item.vertex_buffer) ^ (reinterpret_cast<uintptr_t>(item.index_buffer) << 1);
+
+		auto quantized_depth = static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * ((1u << kDepthBits) - 1));
+
+		return PointerBits(reinterpret_cast<const void*>(buffers), kBufferBits) << kDepthBits | quantized_depth;
+	}
+
+	uint64_t RenderQueue::GetPipelineKey(const GraphicsPipeline* pipeline)
+	{
+		auto [it, inserted] = pipeline_keys_.try_emplace(pipeline, 0);
+		if (inserted)
+		{
+			uint64_t pipeline_id = pipeline_keys_.size() - 1;
+			uint64_t layout_id = layout_ids_.try_emplace(pipeline->GetDesc().binding_layout.Get(), static_cast<uint32_t>(layout_ids_.size())).first->second;
+
+			constexpr uint32_t kPipelineShift = kMaterialBits + kBufferBits + kDepthBits;
+			it->second = (layout_id & ((1u << kLayoutBits) - 1)) << (kPipelineShift + kPipelineBits)
+				| (pipeline_id & ((1u << kPipelineBits) - 1)) << kPipelineShift;
+		}
+		return it->second;
+	}
+
+	uint64_t RenderQueue::GetMaterialKey(const DescriptorTable* descriptor_table)
+	{
+		auto [it, inserted] = material_keys_.try_emplace(descriptor_table, 0);
+		if (inserted)
+		{
+			uint64_t material_id = material_keys_.size() - 1;
+			it->second = (material_id & ((1u << kMaterialBits) - 1)) << (kBufferBits + kDepthBits);
+		}
+		return it->second;
+	}
+
+	void RenderQueue::Sort()
+	{
+		if (entries_.size() < 2)
+		{
+			return;
+		}
+
+		// digits every key shares keep the order, only the differing ones get a pass
+		uint64_t differing_bits = 0;
+		for (const auto& entry : entries_)
+		{
+			differing_bits |= entry.key ^ entries_.front().key;
+		}
+
+		uint32_t max_threads = max_sort_threads_ ? max_sort_threads_ : std::max(std::thread::hardware_concurrency(), 1u);
+		auto num_threads = static_cast<uint32_t>(std::clamp<size_t>(entries_.size() / kMinEntriesPerSortThread, 1, max_threads));
+
+		auto num_entries = entries_.size();
+		scratch_entries_.resize(num_entries);
+
+		// lsd passes, every thread counts and scatters a contiguous block so the passes stay stable
+		std::vector<std::array<uint32_t, kRadix>> offsets(num_threads);
+		for (uint32_t shift = 0; shift < 64; shift += kRadixBits)
+		{
+			if (((differing_bits >> shift) & (kRadix - 1)) == 0)
+			{
+				continue;
+			}
+
+			ParallelFor(num_threads, [&](uint32_t thread)
+			{
+				auto& counts = offsets[thread];
+				counts.fill(0);
+
+				for (size_t i = num_entries * thread / num_threads; i < num_entries * (thread + 1) / num_threads; ++i)
+				{
+					++counts[(entries_[i].key >> shift) & (kRadix - 1)];
+				}
+			});
+
+			uint32_t offset = 0;
+			for (uint32_t digit = 0; digit < kRadix; ++digit)
+			{
+				for (auto& counts : offsets)
+				{
+					auto count = counts[digit];
+					counts[digit] = offset;
+					offset += count;
+				}
+			}
+
+			ParallelFor(num_threads, [&](uint32_t thread)
+			{
+				auto& counts = offsets[thread];
+
+				for (size_t i = num_entries * thread / num_threads; i < num_entries * (thread + 1) / num_threads; ++i)
+				{
+					const auto& entry = entries_[i];
+					scratch_entries_[counts[(entry.key >> shift) & (kRadix - 1)]++] = entry;
+				}
+			});
+
+			entries_.swap(scratch_entries_);
+		}
+	}
+}